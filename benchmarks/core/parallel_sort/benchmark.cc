@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "vial/core/parallel_sort.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+namespace {
+
+auto random_input(size_t size) -> const std::vector<int>& {
+    static std::vector<int> input;
+    if (input.size() != size) {
+        std::mt19937 random{42};
+        input.resize(size);
+        for (auto& value : input) { value = int(random()); }
+    }
+    return input;
+}
+
+void BM_StdSort(benchmark::State& state) {
+    const auto& input = random_input(state.range(0));
+    std::vector<int> values;
+    for (auto _ : state) {
+        state.PauseTiming();
+        values = input;
+        state.ResumeTiming();
+
+        std::sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdSortParallel(benchmark::State& state) {
+    const auto& input = random_input(state.range(0));
+    std::vector<int> values;
+    for (auto _ : state) {
+        state.PauseTiming();
+        values = input;
+        state.ResumeTiming();
+
+        std::sort(std::execution::par, values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_VialParallelSort(benchmark::State& state) {
+    const auto& input = random_input(state.range(0));
+    std::vector<int> values;
+
+    // One running scheduler for every iteration, so only the sort itself is timed
+    vial::Scheduler scheduler;
+    std::thread runner([&]() { scheduler.start(); });
+
+    std::atomic<bool> sorted = false;
+    auto sort = [&]() -> vial::Task<void> {
+        co_await vial::parallel_sort(scheduler, values.begin(), values.end());
+        sorted = true;
+        sorted.notify_one();
+    };
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        values = input;
+        sorted = false;
+        state.ResumeTiming();
+
+        scheduler.fire_and_forget(sort());
+        sorted.wait(false);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    scheduler.stop();
+    runner.join();
+}
+
+} // namespace
+
+// Wall time, since the parallel sorts do their work off the benchmark thread
+BENCHMARK(BM_StdSort)->RangeMultiplier(10)->Range(1000000, 100000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_StdSortParallel)->RangeMultiplier(10)->Range(1000000, 100000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_VialParallelSort)->RangeMultiplier(10)->Range(1000000, 100000000)->Unit(benchmark::kMillisecond)->UseRealTime();
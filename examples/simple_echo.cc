@@ -6,19 +6,20 @@
 using vial::Task;
 
 auto handle_client(vial::net::Socket client) -> Task<void> { 
-    constexpr size_t buffer_size = 1024;
-    std::array<std::byte, buffer_size> buffer{};
+    constexpr size_t max_read = 1024;
     
     while (true) {
-        auto bytes_read = co_await client.read(buffer);
-        if (bytes_read <= 0) {
+        // Buffer is leased from the pool only while there is data to echo
+        auto buffer = co_await client.read(max_read);
+        if (buffer.empty()) {
             std::cout << "[fd:" << client.fd() << "] Client disconnected" << std::endl;
             break;
         }
 
+        auto bytes_read = static_cast<ssize_t>(buffer.size());
         std::cout << "[fd:" << client.fd() << "] Echoing " << bytes_read << " bytes" << std::endl;
 
-        auto bytes_written = co_await client.write(std::span<const std::byte>(buffer.data(), bytes_read));
+        auto bytes_written = co_await client.write(buffer.span());
         if (bytes_written != bytes_read) {
             std::cerr << "[fd:" << client.fd() << "] Write failed" << std::endl;
             break;
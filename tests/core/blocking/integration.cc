@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "vial/core/blocking.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/task_group.hh"
+
+using namespace std::chrono_literals;
+
+TEST(BlockingIntegration, ReturnsResultOffTheWorker) {
+    vial::Scheduler scheduler{1};
+    std::string result;
+    std::thread::id worker;
+    std::thread::id blocking;
+
+    auto parent = [&]() -> vial::Task<void> {
+        worker = std::this_thread::get_id();
+        result = co_await vial::spawn_blocking([&]() {
+            blocking = std::this_thread::get_id();
+            return std::string("done");
+        });
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(result, "done");
+    EXPECT_NE(worker, blocking);
+}
+
+TEST(BlockingIntegration, BlockingCallsDontStallWorkers) {
+    // A single worker: blocking on it would serialise the sleeps and starve the ticker
+    vial::Scheduler scheduler{1};
+    std::atomic<int> ticks = 0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    auto blocker = []() -> vial::Task<void> {
+        co_await vial::spawn_blocking([]() { std::this_thread::sleep_for(50ms); });
+    };
+
+    auto ticker = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 10; i++) {
+            co_await vial::sleep_for(1ms);
+            ticks++;
+        }
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto before = std::chrono::steady_clock::now();
+        vial::TaskGroup group{scheduler};
+        for (int i = 0; i < 8; i++) { group.spawn(blocker()); }
+        group.spawn(ticker());
+        co_await group.join();
+        elapsed = std::chrono::steady_clock::now() - before;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(ticks.load(), 10);
+    EXPECT_LT(elapsed, 300ms);
+}
+
+TEST(BlockingIntegration, RethrowsException) {
+    vial::Scheduler scheduler{1};
+    std::string error;
+
+    auto parent = [&]() -> vial::Task<void> {
+        try {
+            co_await vial::spawn_blocking([]() -> int { throw std::runtime_error("io failed"); });
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(error, "io failed");
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+#include "vial/core/broadcast.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/task_group.hh"
+
+using namespace std::chrono_literals;
+
+TEST(BroadcastIntegration, EveryReceiverSeesEveryValue) {
+    vial::Scheduler scheduler{2};
+    auto [sender, first] = vial::broadcast<int>(16);
+    auto second = sender.subscribe();
+    std::vector<int> seen_first;
+    std::vector<int> seen_second;
+
+    auto listen = [](vial::BroadcastReceiver<int>& receiver, std::vector<int>& seen) -> vial::Task<void> {
+        while (auto value = co_await receiver.recv()) { seen.push_back(*value); }
+    };
+
+    auto publish = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 10; i++) {
+            sender.send(i);
+            co_await vial::sleep_for(1ms);
+        }
+        sender.close();
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        group.spawn(listen(first, seen_first));
+        group.spawn(listen(second, seen_second));
+        group.spawn(publish());
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    std::vector<int> expected{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(seen_first, expected);
+    EXPECT_EQ(seen_second, expected);
+}
+
+TEST(BroadcastIntegration, LaggingReceiverSkipsAhead) {
+    auto [sender, receiver] = vial::broadcast<int>(4);
+    for (int i = 0; i < 10; i++) { sender.send(i); }
+
+    EXPECT_EQ(receiver.try_recv(), 6);
+    EXPECT_EQ(receiver.missed(), 6);
+    EXPECT_EQ(receiver.try_recv(), 7);
+    EXPECT_EQ(receiver.try_recv(), 8);
+    EXPECT_EQ(receiver.try_recv(), 9);
+    EXPECT_EQ(receiver.try_recv(), std::nullopt);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "vial/core/budget.hh"
+#include "vial/core/io/io_awaitables.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+#include "vial/core/yield.hh"
+
+TEST(BudgetIntegration, YieldRunsQueuedTasksFirst) {
+    vial::Scheduler scheduler{1};
+    std::string order;
+
+    auto yielder = [&]() -> vial::Task<void> {
+        order += 'a';
+        co_await vial::yield();
+        order += 'a';
+        scheduler.stop();
+    };
+    auto other = [&]() -> vial::Task<void> {
+        order += 'b';
+        co_return;
+    };
+
+    scheduler.fire_and_forget(yielder());
+    scheduler.fire_and_forget(other());
+    scheduler.start();
+
+    EXPECT_EQ(order, "aba");
+}
+
+TEST(BudgetIntegration, AlwaysReadyFdYieldsWhenBudgetRunsOut) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+
+    vial::Scheduler scheduler{1};
+    constexpr int kWaits = 3 * static_cast<int>(vial::kTaskBudget);
+    int waits = 0;
+    int waits_when_other_ran = -1;
+
+    // Never reads, so the fd stays readable and no wait ever has to suspend
+    auto reader = [&]() -> vial::Task<void> {
+        for (; waits < kWaits; waits++) {
+            co_await vial::WaitForRead{fds[0]};
+        }
+        scheduler.stop();
+    };
+    auto other = [&]() -> vial::Task<void> {
+        waits_when_other_ran = waits;
+        co_return;
+    };
+
+    scheduler.fire_and_forget(reader());
+    scheduler.fire_and_forget(other());
+    scheduler.start();
+
+    EXPECT_EQ(waits, kWaits);
+    EXPECT_EQ(waits_when_other_ran, static_cast<int>(vial::kTaskBudget));
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(BudgetIntegration, BudgetIsRefilledOnResume) {
+    vial::Scheduler scheduler{1};
+    uint32_t before = 0;
+    uint32_t after = 0;
+
+    auto task = [&]() -> vial::Task<void> {
+        while (vial::CoopBudget::consume()) {}
+        before = vial::CoopBudget::remaining();
+        co_await vial::yield();
+        after = vial::CoopBudget::remaining();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(task());
+    scheduler.start();
+
+    EXPECT_EQ(before, 0);
+    EXPECT_EQ(after, vial::kTaskBudget);
+}
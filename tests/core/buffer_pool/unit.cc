@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+
+#include "vial/core/buffer_pool.hh"
+
+TEST(BufferPoolUnit, RoundsUpToSizeClass) {
+  auto& pool = vial::BufferPool::instance();
+
+  auto small = pool.lease(1);
+  EXPECT_EQ(small.capacity(), vial::kBufferSizeClasses[0]);
+  EXPECT_TRUE(small.empty());
+
+  auto medium = pool.lease(vial::kBufferSizeClasses[1] - 1);
+  EXPECT_EQ(medium.capacity(), vial::kBufferSizeClasses[1]);
+
+  const size_t huge = vial::kBufferSizeClasses.back() + 1;
+  auto large = pool.lease(huge);
+  EXPECT_EQ(large.capacity(), huge);
+}
+
+TEST(BufferPoolUnit, ReusesReturnedBuffer) {
+  auto& pool = vial::BufferPool::instance();
+
+  std::byte* first = nullptr;
+  {
+    auto buffer = pool.lease(100);
+    first = buffer.data();
+  }
+
+  auto buffer = pool.lease(100);
+  EXPECT_EQ(buffer.data(), first);
+}
+
+TEST(BufferPoolUnit, ResizeClampsToCapacity) {
+  auto buffer = vial::BufferPool::instance().lease(10);
+
+  buffer.resize(5);
+  EXPECT_EQ(buffer.size(), 5);
+  EXPECT_EQ(buffer.span().size(), 5);
+
+  buffer.resize(buffer.capacity() + 1);
+  EXPECT_EQ(buffer.size(), buffer.capacity());
+}
+
+TEST(BufferPoolUnit, MoveTransfersOwnership) {
+  auto buffer = vial::BufferPool::instance().lease(10);
+  std::byte* data = buffer.data();
+
+  vial::Buffer moved = std::move(buffer);
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(buffer.data(), nullptr); // NOLINT
+}
+
+TEST(BufferPoolUnit, BuffersFlowBetweenThreads) {
+  auto& pool = vial::BufferPool::instance();
+  const size_t count = vial::kMaxCachedBuffers * 4;
+
+  // Lease on one thread, return on another: the returning thread spills to the depot
+  std::vector<vial::Buffer> leased;
+  std::thread producer([&]() {
+    for (size_t i = 0; i < count; i++) { leased.push_back(pool.lease(vial::kBufferSizeClasses[2])); }
+  });
+  producer.join();
+
+  std::set<std::byte*> returned;
+  for (auto& buffer : leased) { returned.insert(buffer.data()); }
+  leased.clear();
+
+  // A fresh thread refills from the depot instead of allocating
+  size_t reused = 0;
+  std::thread consumer([&]() {
+    std::vector<vial::Buffer> again;
+    for (size_t i = 0; i < vial::kBufferTransferBatch; i++) {
+      again.push_back(pool.lease(vial::kBufferSizeClasses[2]));
+      reused += returned.contains(again.back().data()) ? 1 : 0;
+    }
+  });
+  consumer.join();
+
+  EXPECT_EQ(reused, vial::kBufferTransferBatch);
+}
+
+TEST(BufferPoolUnit, ArenaBuffersAreDistinctAndAligned) {
+  auto& pool = vial::BufferPool::instance();
+
+  std::vector<vial::Buffer> leased;
+  std::set<std::byte*> seen;
+  for (size_t i = 0; i < vial::kArenaBuffersPerClass + 1; i++) {
+    leased.push_back(pool.lease(vial::kBufferSizeClasses[2]));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(leased.back().data()) % 64, 0);
+    seen.insert(leased.back().data());
+  }
+  EXPECT_EQ(seen.size(), leased.size());
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include "vial/core/cancellation.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+
+using namespace std::chrono_literals;
+
+TEST(CancellationIntegration, EmptyTokenNeverCancels) {
+    vial::CancellationToken token;
+    EXPECT_FALSE(token);
+    token.cancel();
+    EXPECT_FALSE(token.is_cancelled());
+
+    auto real = vial::CancellationToken::create();
+    int calls = 0;
+    auto id = real.on_cancel([&]() { calls++; });
+    real.on_cancel([&]() { calls += 10; });
+    real.remove(id);
+    real.cancel();
+    real.cancel();
+    EXPECT_TRUE(real.is_cancelled());
+    EXPECT_EQ(calls, 10);
+
+    // Registering after cancellation runs the callback right away
+    EXPECT_EQ(real.on_cancel([&]() { calls++; }), 0);
+    EXPECT_EQ(calls, 11);
+}
+
+TEST(CancellationIntegration, CancelWakesSleepingChild) {
+    vial::Scheduler scheduler{1};
+    auto token = vial::CancellationToken::create();
+
+    vial::WaitStatus child_status = vial::WaitStatus::kReady;
+    bool child_inherited = false;
+    std::chrono::steady_clock::duration slept{};
+
+    auto child = [&]() -> vial::Task<void> {
+        child_inherited = static_cast<bool>(vial::CancellationToken::current());
+        auto before = std::chrono::steady_clock::now();
+        child_status = co_await vial::sleep_for(10s);
+        slept = std::chrono::steady_clock::now() - before;
+        co_return;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto spawned = scheduler.spawn_task(child());
+        co_await spawned;
+        scheduler.stop();
+    };
+
+    auto canceller = [&]() -> vial::Task<void> {
+        co_await vial::sleep_for(10ms);
+        token.cancel();
+        co_return;
+    };
+
+    auto root = parent();
+    root.set_cancellation_token(token);
+    scheduler.fire_and_forget(root);
+    scheduler.fire_and_forget(canceller());
+    scheduler.start();
+
+    EXPECT_TRUE(child_inherited);
+    EXPECT_EQ(child_status, vial::WaitStatus::kCancelled);
+    EXPECT_LT(slept, 5s);
+}
+
+TEST(CancellationIntegration, CancelledTaskDoesNotSuspend) {
+    vial::Scheduler scheduler{1};
+    auto token = vial::CancellationToken::create();
+    token.cancel();
+
+    vial::WaitStatus status = vial::WaitStatus::kReady;
+    auto task = [&]() -> vial::Task<void> {
+        status = co_await vial::sleep_for(10s);
+        scheduler.stop();
+    };
+
+    auto root = task();
+    root.set_cancellation_token(token);
+    scheduler.fire_and_forget(root);
+    scheduler.start();
+
+    EXPECT_EQ(status, vial::WaitStatus::kCancelled);
+}
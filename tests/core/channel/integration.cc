@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "vial/core/channel.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/task_group.hh"
+
+using namespace std::chrono_literals;
+
+TEST(ChannelIntegration, BoundedRingWrapsAround) {
+    vial::BoundedRing<int> ring{3};
+    EXPECT_EQ(ring.capacity(), 4);
+
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 4; i++) {
+            int value = round * 4 + i;
+            EXPECT_TRUE(ring.try_push(value));
+        }
+        int extra = -1;
+        EXPECT_FALSE(ring.try_push(extra));
+        EXPECT_EQ(extra, -1);
+        for (int i = 0; i < 4; i++) { EXPECT_EQ(ring.try_pop(), round * 4 + i); }
+        EXPECT_EQ(ring.try_pop(), std::nullopt);
+    }
+}
+
+TEST(ChannelIntegration, UnboundedRingSpansSegments) {
+    vial::UnboundedRing<std::string> ring;
+    for (int i = 0; i < 1000; i++) {
+        std::string value = std::to_string(i);
+        EXPECT_TRUE(ring.try_push(value));
+    }
+    for (int i = 0; i < 1000; i++) { EXPECT_EQ(ring.try_pop(), std::to_string(i)); }
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+}
+
+TEST(ChannelIntegration, BackpressureKeepsOrder) {
+    vial::Scheduler scheduler{2};
+    vial::Channel<int> channel{4};
+    std::vector<int> received;
+
+    auto producer = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 1000; i++) { co_await channel.send(i); }
+        channel.close();
+    };
+
+    auto consumer = [&]() -> vial::Task<void> {
+        while (auto value = co_await channel.recv()) {
+            received.push_back(*value);
+            if (*value % 100 == 0) { co_await vial::sleep_for(1ms); }
+        }
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        group.spawn(consumer());
+        group.spawn(producer());
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    ASSERT_EQ(received.size(), 1000);
+    for (int i = 0; i < 1000; i++) { EXPECT_EQ(received[i], i); }
+}
+
+template <typename Channel>
+void many_to_many(Channel& channel) {
+    vial::Scheduler scheduler{2};
+    std::atomic<int64_t> sum = 0;
+    std::atomic<int> count = 0;
+    std::atomic<int> producers_left = 4;
+
+    auto producer = [&](int base) -> vial::Task<void> {
+        for (int i = 0; i < 500; i++) { co_await channel.send(base + i); }
+        if (--producers_left == 0) { channel.close(); }
+    };
+
+    auto consumer = [&]() -> vial::Task<void> {
+        while (auto value = co_await channel.recv()) {
+            sum += *value;
+            count++;
+        }
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        for (int i = 0; i < 3; i++) { group.spawn(consumer()); }
+        for (int i = 0; i < 4; i++) { group.spawn(producer(i * 500)); }
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(count.load(), 2000);
+    EXPECT_EQ(sum.load(), 1999 * 2000 / 2);
+}
+
+TEST(ChannelIntegration, ManyToManyBounded) {
+    vial::Channel<int> channel{8};
+    many_to_many(channel);
+}
+
+TEST(ChannelIntegration, ManyToManyUnbounded) {
+    vial::UnboundedChannel<int> channel;
+    many_to_many(channel);
+}
+
+TEST(ChannelIntegration, CloseFailsSendAndWakesReceivers) {
+    vial::Scheduler scheduler{1};
+    vial::Channel<int> channel{2};
+    bool third_send = true;
+    std::optional<int> after_close = 0;
+
+    auto sender = [&]() -> vial::Task<void> {
+        co_await channel.send(1);
+        co_await channel.send(2);
+        // Buffer is full until the channel is closed
+        third_send = co_await channel.send(3);
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        group.spawn(sender());
+        co_await vial::sleep_for(5ms);
+        channel.close();
+        co_await group.join();
+
+        EXPECT_EQ(co_await channel.recv(), 1);
+        EXPECT_EQ(co_await channel.recv(), 2);
+        after_close = co_await channel.recv();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_FALSE(third_send);
+    EXPECT_EQ(after_close, std::nullopt);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "vial/core/blocking.hh"
+#include "vial/core/channel.hh"
+#include "vial/core/queue.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+using namespace std::chrono_literals;
+
+TEST(InboxIntegration, KeepsEachProducersOrder) {
+    constexpr int kProducers = 4;
+    constexpr int kItems = 20000;
+    struct Item {
+        int producer;
+        int sequence;
+        Item* inbox_next = nullptr;
+    };
+    vial::Inbox<Item> inbox;
+    std::atomic<int> finished = 0;
+
+    std::vector<std::vector<Item>> items(kProducers);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        for (int i = 0; i < kItems; i++) { items[p].push_back({p, i}); }
+        producers.emplace_back([&, p]() {
+            for (auto& item : items[p]) { inbox.push(&item); }
+            finished++;
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    bool in_order = true;
+    auto check = [&](Item* item) {
+        in_order = in_order && item->sequence == next[item->producer];
+        next[item->producer]++;
+    };
+    while (finished.load() < kProducers) { inbox.drain(check); }
+    inbox.drain(check);
+
+    for (auto& producer : producers) { producer.join(); }
+    EXPECT_TRUE(in_order);
+    for (int count : next) { EXPECT_EQ(count, kItems); }
+    EXPECT_TRUE(inbox.empty());
+}
+
+TEST(InboxIntegration, OffWorkerWakeupsResumeOnTheOwningWorker) {
+    vial::Scheduler scheduler{2};
+    int mismatches = 0;
+
+    auto task = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 20; i++) {
+            auto before = scheduler.current_worker();
+            co_await vial::spawn_blocking([]() { std::this_thread::sleep_for(100us); });
+            if (scheduler.current_worker() != before) { mismatches++; }
+        }
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(task());
+    scheduler.start();
+
+    EXPECT_EQ(mismatches, 0);
+}
+
+TEST(InboxIntegration, CrossWorkerWakeupsResumeOnTheWakingWorker) {
+    vial::Scheduler scheduler{2};
+    vial::Channel<int> channel{2};
+    std::atomic<bool> receiving = false;
+    std::optional<size_t> before;
+    std::optional<size_t> after;
+    std::optional<size_t> sender;
+    std::optional<int> received;
+
+    auto receiver = [&]() -> vial::Task<void> {
+        before = scheduler.current_worker();
+        receiving = true;
+        received = co_await channel.recv();
+        after = scheduler.current_worker();
+        scheduler.stop();
+    };
+    // Holds its worker until the receiver is running, so they end up on different workers
+    auto send = [&]() -> vial::Task<void> {
+        while (!receiving) {}
+        std::this_thread::sleep_for(5ms);
+        sender = scheduler.current_worker();
+        int value = 7;
+        channel.try_send(value);
+        co_return;
+    };
+
+    scheduler.fire_and_forget(send());
+    scheduler.fire_and_forget(receiver());
+    scheduler.start();
+
+    EXPECT_EQ(received, 7);
+    EXPECT_NE(before, sender);
+    EXPECT_EQ(after, sender);
+}
+
+TEST(InboxIntegration, WakeupsForABusyWorkerGoToIdleWorkers) {
+    vial::Scheduler scheduler{2};
+    std::atomic<bool> holding = false;
+    std::atomic<bool> release = false;
+    std::atomic<bool> resumed = false;
+    std::optional<size_t> before;
+    std::optional<size_t> after;
+
+    // Keeps the other worker busy until the long task runs, so nothing below goes global
+    auto hold = [&]() -> vial::Task<void> {
+        holding = true;
+        while (!release) {}
+        co_return;
+    };
+
+    // Occupies the waiter's worker for the whole wait
+    auto long_task = [&]() -> vial::Task<void> {
+        release = true;
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (!resumed && std::chrono::steady_clock::now() < deadline) { std::this_thread::yield(); }
+        co_return;
+    };
+
+    auto waiter = [&]() -> vial::Task<void> {
+        while (!holding) {}
+        before = scheduler.current_worker();
+        scheduler.fire_and_forget(long_task());
+        co_await vial::spawn_blocking([]() { std::this_thread::sleep_for(10ms); });
+        after = scheduler.current_worker();
+        resumed = true;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(hold());
+    scheduler.fire_and_forget(waiter());
+    scheduler.start();
+
+    EXPECT_NE(before, after);
+}
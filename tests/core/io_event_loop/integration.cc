@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "vial/core/io/io_event_loop.hh"
+#include "tests/support/io_thread.hh"
+
+namespace {
+
+using vial::test::IOThread;
+
+using namespace std::chrono_literals;
+
+//! A socketpair whose `local` end is registered with the IOEventLoop.
+class RegisteredPair {
+  public:
+    RegisteredPair() {
+        int fds[2];
+        ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+        local = fds[0];
+        peer = fds[1];
+        vial::IOEventLoop::instance().register_fd(local);
+    }
+    RegisteredPair(const RegisteredPair&) = delete;
+    RegisteredPair(RegisteredPair&&) = delete;
+    auto operator=(const RegisteredPair&) -> RegisteredPair& = delete;
+    auto operator=(RegisteredPair&&) -> RegisteredPair& = delete;
+    ~RegisteredPair() {
+        auto& loop = vial::IOEventLoop::instance();
+        loop.cancel_read_callback(local);
+        loop.cancel_write_callback(local);
+        loop.unregister_fd(local);
+        ::close(local);
+        ::close(peer);
+    }
+
+    int local = -1;
+    int peer = -1;
+};
+
+//! Spin until `done` returns true, or give up after a second.
+template <typename F> auto wait_until(F done) -> bool {
+    auto deadline = std::chrono::steady_clock::now() + 1s;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) { return false; }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(IOEventLoopIntegration, StaleReadSequenceDispatchesImmediately) {
+    RegisteredPair pair;
+    auto& loop = vial::IOEventLoop::instance();
+    uint32_t since = loop.read_sequence(pair.local);
+
+    IOThread io;
+    char byte = 1;
+    ASSERT_EQ(::write(pair.peer, &byte, 1), 1);
+    ASSERT_TRUE(wait_until([&]() { return loop.read_sequence(pair.local) != since; }));
+
+    // The event arrived after the snapshot, so the callback runs on the registering thread
+    std::thread::id ran_on;
+    loop.register_read_callback(pair.local, [&]() { ran_on = std::this_thread::get_id(); }, since);
+    EXPECT_EQ(ran_on, std::this_thread::get_id());
+}
+
+TEST(IOEventLoopIntegration, MatchingReadSequenceParksUntilNextEvent) {
+    RegisteredPair pair;
+    auto& loop = vial::IOEventLoop::instance();
+    uint32_t since = loop.read_sequence(pair.local);
+
+    std::atomic<bool> ran = false;
+    loop.register_read_callback(pair.local, [&]() { ran = true; }, since);
+    EXPECT_FALSE(ran);
+
+    IOThread io;
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(ran);
+    EXPECT_EQ(loop.read_sequence(pair.local), since);
+
+    char byte = 1;
+    ASSERT_EQ(::write(pair.peer, &byte, 1), 1);
+    EXPECT_TRUE(wait_until([&]() { return ran.load(); }));
+    EXPECT_NE(loop.read_sequence(pair.local), since);
+}
+
+TEST(IOEventLoopIntegration, StaleWriteSequenceDispatchesImmediately) {
+    RegisteredPair pair;
+    auto& loop = vial::IOEventLoop::instance();
+    uint32_t since = loop.write_sequence(pair.local);
+
+    // An empty socket is writable, so the loop reports it as soon as it runs
+    IOThread io;
+    ASSERT_TRUE(wait_until([&]() { return loop.write_sequence(pair.local) != since; }));
+
+    std::thread::id ran_on;
+    loop.register_write_callback(pair.local, [&]() { ran_on = std::this_thread::get_id(); }, since);
+    EXPECT_EQ(ran_on, std::this_thread::get_id());
+}
+
+TEST(IOEventLoopIntegration, MatchingWriteSequenceParksUntilNextEvent) {
+    RegisteredPair pair;
+    auto& loop = vial::IOEventLoop::instance();
+    uint32_t since = loop.write_sequence(pair.local);
+
+    // Without the loop running no event can arrive, so the callback must stay parked
+    std::atomic<bool> ran = false;
+    loop.register_write_callback(pair.local, [&]() { ran = true; }, since);
+    EXPECT_FALSE(ran);
+
+    IOThread io;
+    EXPECT_TRUE(wait_until([&]() { return ran.load(); }));
+    EXPECT_NE(loop.write_sequence(pair.local), since);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+TEST(LifoIntegration, LatestSpawnRunsNext) {
+    vial::Scheduler scheduler{1};
+    std::string order;
+
+    auto record = [&](char c) -> vial::Task<void> {
+        order += c;
+        if (order.size() == 3) { scheduler.stop(); }
+        co_return;
+    };
+    auto parent = [&]() -> vial::Task<void> {
+        scheduler.fire_and_forget(record('x'));
+        scheduler.fire_and_forget(record('y'));
+        scheduler.fire_and_forget(record('z'));
+        co_return;
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(order, "zxy");
+}
+
+TEST(LifoIntegration, LatestSpawnStaysOnItsWorkerWhileOthersIdle) {
+    vial::Scheduler scheduler{2};
+    std::optional<size_t> parent_worker;
+    std::optional<size_t> child_worker;
+
+    auto child = [&]() -> vial::Task<void> {
+        child_worker = scheduler.current_worker();
+        scheduler.stop();
+        co_return;
+    };
+    auto parent = [&]() -> vial::Task<void> {
+        // Spawn only once the other worker is looking for work
+        while (scheduler.idle_workers() == 0) {}
+        parent_worker = scheduler.current_worker();
+        scheduler.fire_and_forget(child());
+        co_return;
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    ASSERT_TRUE(parent_worker.has_value());
+    EXPECT_EQ(child_worker, parent_worker);
+}
+
+TEST(LifoIntegration, PingPongDoesNotStarveQueuedTasks) {
+    vial::Scheduler scheduler{1};
+    bool queued_ran = false;
+    int ping_pongs = 0;
+    int ping_pongs_before_queued = -1;
+
+    // Each run readies the next one, which always lands in the LIFO slot
+    auto ping_pong = [&](auto& self) -> vial::Task<void> {
+        ping_pongs++;
+        if (!queued_ran) { scheduler.fire_and_forget(self(self)); }
+        co_return;
+    };
+    auto queued = [&]() -> vial::Task<void> {
+        queued_ran = true;
+        ping_pongs_before_queued = ping_pongs;
+        scheduler.stop();
+        co_return;
+    };
+    auto parent = [&]() -> vial::Task<void> {
+        scheduler.fire_and_forget(queued());
+        scheduler.fire_and_forget(ping_pong(ping_pong));
+        co_return;
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_TRUE(queued_ran);
+    EXPECT_EQ(ping_pongs_before_queued, static_cast<int>(vial::kMaxLifoRuns));
+}
+
+TEST(LifoIntegration, AwaitChainsComplete) {
+    vial::Scheduler scheduler{1};
+    int result = 0;
+
+    auto leaf = [](int x) -> vial::Task<int> { co_return x + 1; };
+    auto middle = [&](int x) -> vial::Task<int> {
+        int a = co_await leaf(x);
+        int b = co_await leaf(a);
+        co_return b;
+    };
+    auto parent = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 100; i++) { result = co_await middle(result); }
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(result, 200);
+}
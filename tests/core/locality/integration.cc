@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <optional>
+#include <vector>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+TEST(LocalityIntegration, CurrentWorkerIsSetInsideTasks) {
+    vial::Scheduler scheduler{2};
+    std::optional<size_t> inside;
+    std::optional<size_t> any_scheduler;
+
+    auto task = [&]() -> vial::Task<void> {
+        inside = scheduler.current_worker();
+        any_scheduler = vial::Scheduler::current_worker_id();
+        scheduler.stop();
+        co_return;
+    };
+
+    scheduler.fire_and_forget(task());
+    scheduler.start();
+
+    ASSERT_TRUE(inside.has_value());
+    EXPECT_LT(*inside, 2U);
+    EXPECT_EQ(inside, any_scheduler);
+    EXPECT_FALSE(scheduler.current_worker().has_value());
+    EXPECT_FALSE(vial::Scheduler::current_worker_id().has_value());
+}
+
+TEST(LocalityIntegration, SpawnsStayOnTheSpawningWorker) {
+    vial::Scheduler scheduler{2};
+    std::atomic<bool> hog_started = false;
+    std::atomic<bool> done = false;
+    std::optional<size_t> parent_worker;
+    std::vector<std::optional<size_t>> child_workers(64);
+
+    // Keeps the other worker busy, so no worker is idle and spawns aren't shared
+    auto hog = [&]() -> vial::Task<void> {
+        hog_started = true;
+        while (!done) {}
+        co_return;
+    };
+    auto child = [&](size_t i) -> vial::Task<void> {
+        child_workers[i] = scheduler.current_worker();
+        co_return;
+    };
+    auto parent = [&]() -> vial::Task<void> {
+        while (!hog_started) {}
+        parent_worker = scheduler.current_worker();
+
+        std::vector<vial::Task<void>> children;
+        for (size_t i = 0; i < child_workers.size(); i++) {
+            children.push_back(scheduler.spawn_task(child(i)));
+        }
+        for (auto& task : children) { co_await task; }
+
+        done = true;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(hog());
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    ASSERT_TRUE(parent_worker.has_value());
+    for (const auto& worker : child_workers) { EXPECT_EQ(worker, parent_worker); }
+}
+
+TEST(LocalityIntegration, GlobalQueueIsNotStarvedByLocalWork) {
+    vial::Scheduler scheduler{1};
+    bool external_ran = false;
+    int local_runs = 0;
+
+    // Each run queues the next one on the worker's local queue
+    auto local = [&](auto& self) -> vial::Task<void> {
+        local_runs++;
+        if (!external_ran) { scheduler.fire_and_forget(self(self)); }
+        co_return;
+    };
+    auto external = [&]() -> vial::Task<void> {
+        external_ran = true;
+        scheduler.stop();
+        co_return;
+    };
+
+    scheduler.fire_and_forget(local(local));
+    scheduler.fire_and_forget(external());
+    scheduler.start();
+
+    EXPECT_TRUE(external_ran);
+    EXPECT_LE(local_runs, static_cast<int>(vial::kGlobalPollInterval));
+}
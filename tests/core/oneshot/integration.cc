@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include "vial/core/oneshot.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+
+using namespace std::chrono_literals;
+
+TEST(OneshotIntegration, DeliversResponse) {
+    vial::Scheduler scheduler{2};
+    std::optional<std::string> response;
+
+    auto responder = [](vial::OneshotSender<std::string> sender) -> vial::Task<void> {
+        co_await vial::sleep_for(2ms);
+        sender.send("pong");
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto [sender, receiver] = vial::oneshot<std::string>();
+        scheduler.fire_and_forget(responder(std::move(sender)));
+        response = co_await receiver;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(response, "pong");
+}
+
+TEST(OneshotIntegration, DroppedSenderYieldsNothing) {
+    vial::Scheduler scheduler{1};
+    std::optional<int> response = 0;
+
+    auto responder = [](vial::OneshotSender<int> sender) -> vial::Task<void> {
+        co_await vial::sleep_for(2ms);
+        // Dropped without sending
+        auto dropped = std::move(sender);
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto [sender, receiver] = vial::oneshot<int>();
+        scheduler.fire_and_forget(responder(std::move(sender)));
+        response = co_await receiver;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(response, std::nullopt);
+}
+
+TEST(OneshotIntegration, ValueSentBeforeAwait) {
+    auto [sender, receiver] = vial::oneshot<int>();
+    EXPECT_FALSE(receiver.is_ready());
+    sender.send(7);
+    EXPECT_TRUE(receiver.is_ready());
+    EXPECT_EQ(receiver.await_resume(), 7);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vial/core/parallel.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+TEST(ParallelIntegration, ForVisitsEveryIndexOnce) {
+    vial::Scheduler scheduler{4};
+    std::vector<int> values(1000000, 1);
+
+    auto parent = [&]() -> vial::Task<void> {
+        co_await vial::parallel_for(scheduler, size_t{0}, values.size(), [&](size_t i) { values[i] += int(i % 7); });
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    for (size_t i = 0; i < values.size(); i++) { ASSERT_EQ(values[i], 1 + int(i % 7)); }
+}
+
+TEST(ParallelIntegration, ReduceSums) {
+    vial::Scheduler scheduler{4};
+    int64_t sum = 0;
+
+    auto parent = [&]() -> vial::Task<void> {
+        sum = co_await vial::parallel_reduce(
+            scheduler, int64_t{0}, int64_t{10000000}, int64_t{0},
+            [](int64_t accumulator, int64_t i) { return accumulator + i; }, std::plus<>{});
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(sum, int64_t{10000000} * 9999999 / 2);
+}
+
+TEST(ParallelIntegration, ReduceKeepsOrder) {
+    vial::Scheduler scheduler{4};
+    std::string joined;
+
+    auto parent = [&]() -> vial::Task<void> {
+        // Concatenation is associative but not commutative
+        joined = co_await vial::parallel_reduce(
+            scheduler, 0, 20000, std::string{},
+            [](std::string accumulator, int i) { return accumulator + char('a' + i % 26); },
+            [](std::string left, const std::string& right) { return left + right; });
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    ASSERT_EQ(joined.size(), 20000);
+    for (int i = 0; i < 20000; i++) { ASSERT_EQ(joined[i], char('a' + i % 26)); }
+}
+
+TEST(ParallelIntegration, ForRethrowsBodyException) {
+    vial::Scheduler scheduler{2};
+    std::string error;
+
+    auto parent = [&]() -> vial::Task<void> {
+        try {
+            co_await vial::parallel_for(scheduler, 0, 100000, [](int i) {
+                if (i == 4242) { throw std::runtime_error("bad element"); }
+            });
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(error, "bad element");
+}
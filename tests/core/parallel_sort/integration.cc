@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vial/core/parallel_sort.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+template <typename T, typename Compare = std::less<>>
+void sort_with_scheduler(std::vector<T>& values, Compare comp = {}) {
+    vial::Scheduler scheduler{4};
+
+    auto parent = [&]() -> vial::Task<void> {
+        co_await vial::parallel_sort(scheduler, values.begin(), values.end(), comp);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+}
+
+TEST(ParallelSortIntegration, SortsLargeRandomInput) {
+    std::mt19937 random{42};
+    std::vector<int> values(1000000);
+    for (auto& value : values) { value = int(random()); }
+
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    sort_with_scheduler(values);
+    EXPECT_TRUE(values == expected);
+}
+
+TEST(ParallelSortIntegration, SortsWithComparatorAndDuplicates) {
+    std::mt19937 random{7};
+    std::vector<int> values(300000);
+    for (auto& value : values) { value = int(random() % 100); }
+
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<>{});
+
+    sort_with_scheduler(values, std::greater<>{});
+    EXPECT_TRUE(values == expected);
+}
+
+TEST(ParallelSortIntegration, SortsStrings) {
+    std::mt19937 random{3};
+    std::vector<std::string> values(100000);
+    for (auto& value : values) { value = std::to_string(random()); }
+
+    std::vector<std::string> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    sort_with_scheduler(values);
+    EXPECT_TRUE(values == expected);
+}
+
+TEST(ParallelSortIntegration, SortsSmallInput) {
+    std::vector<int> values = { 5, 4, 6, 7, 8, 9 };
+    sort_with_scheduler(values);
+    EXPECT_EQ(values, (std::vector<int>{ 4, 5, 6, 7, 8, 9 }));
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "vial/core/priority.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+
+TEST(PriorityIntegration, LatencyRunsBeforeQueuedBackgroundWork) {
+    vial::Scheduler scheduler{1};
+    std::string order;
+
+    auto record = [&](char c, bool last) -> vial::Task<void> {
+        order += c;
+        if (last) { scheduler.stop(); }
+        co_return;
+    };
+
+    for (int i = 0; i < 4; i++) {
+        scheduler.fire_and_forget(record('b', i == 3), vial::TaskPriority::kBackground);
+    }
+    scheduler.fire_and_forget(record('n', false));
+    scheduler.fire_and_forget(record('l', false), vial::TaskPriority::kLatency);
+    scheduler.start();
+
+    EXPECT_EQ(order, "lnbbbb");
+}
+
+TEST(PriorityIntegration, BackgroundIsNotStarved) {
+    vial::Scheduler scheduler{1};
+    bool background_ran = false;
+    int latency_runs = 0;
+
+    // Each latency task queues the next one, so the latency level is never empty
+    auto latency = [&](auto& self) -> vial::Task<void> {
+        latency_runs++;
+        if (!background_ran) { scheduler.fire_and_forget(self(self)); }
+        co_return;
+    };
+    auto background = [&]() -> vial::Task<void> {
+        background_ran = true;
+        scheduler.stop();
+        co_return;
+    };
+
+    scheduler.fire_and_forget(latency(latency), vial::TaskPriority::kLatency);
+    scheduler.fire_and_forget(background(), vial::TaskPriority::kBackground);
+    scheduler.start();
+
+    EXPECT_TRUE(background_ran);
+    EXPECT_LE(latency_runs, static_cast<int>(vial::kBackgroundPickInterval));
+}
+
+TEST(PriorityIntegration, TasksInheritTheirCreatorsPriority) {
+    vial::Scheduler scheduler{1};
+    vial::TaskPriority awaited = vial::TaskPriority::kNormal;
+    vial::TaskPriority spawned = vial::TaskPriority::kNormal;
+    vial::TaskPriority overridden = vial::TaskPriority::kNormal;
+
+    auto observe = [](vial::TaskPriority& out) -> vial::Task<void> {
+        out = vial::current_priority();
+        co_return;
+    };
+    auto parent = [&]() -> vial::Task<void> {
+        co_await observe(awaited);
+        co_await scheduler.spawn_task(observe(spawned));
+        co_await scheduler.spawn_task(observe(overridden), vial::TaskPriority::kBackground);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent(), vial::TaskPriority::kLatency);
+    scheduler.start();
+
+    EXPECT_EQ(awaited, vial::TaskPriority::kLatency);
+    EXPECT_EQ(spawned, vial::TaskPriority::kLatency);
+    EXPECT_EQ(overridden, vial::TaskPriority::kBackground);
+    EXPECT_EQ(vial::current_priority(), vial::TaskPriority::kNormal);
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <numeric>
+#include <optional>
+#include <thread>
 
 #include "vial/core/scheduler.hh"
 #include "vial/core/task.hh"
@@ -122,3 +126,48 @@ TEST(SchedulerIntegration, MergeSortLargeMultiThreaded) {
 
     EXPECT_TRUE(equal);
 }
+
+TEST(SchedulerIntegration, IdleWorkersStealQueuedTasks) {
+    constexpr int kChildren = 8;
+    vial::Scheduler scheduler{2};
+    std::atomic<bool> busy_running = false;
+    std::atomic<bool> spawned = false;
+    std::atomic<int> done = 0;
+    std::atomic<int> stolen = 0;
+    std::optional<size_t> parent_worker;
+
+    // Keeps the other worker busy while the children are queued, so they stay local
+    auto busy = [&]() -> vial::Task<void> {
+        busy_running = true;
+        while (!spawned) {}
+        co_return;
+    };
+
+    auto child = [&]() -> vial::Task<void> {
+        if (scheduler.current_worker() != parent_worker) { stolen++; }
+        done++;
+        co_return;
+    };
+
+    // Holds its worker until the children ran, which only happens if the other worker steals them
+    auto parent = [&]() -> vial::Task<void> {
+        while (!busy_running) {}
+        parent_worker = scheduler.current_worker();
+        for (int i = 0; i < kChildren; i++) { scheduler.fire_and_forget(child()); }
+        spawned = true;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (done.load() < kChildren - 1 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        scheduler.stop();
+        co_return;
+    };
+
+    scheduler.fire_and_forget(busy());
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    // The newest child sits in the parent's LIFO slot, which can't be stolen
+    EXPECT_EQ(stolen.load(), kChildren - 1);
+}
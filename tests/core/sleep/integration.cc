@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+
+using namespace std::chrono_literals;
+
+TEST(SleepIntegration, SleepForSuspends) {
+    vial::Scheduler scheduler{1};
+    std::chrono::steady_clock::duration slept{};
+
+    auto sleeper = [&]() -> vial::Task<void> {
+        auto before = std::chrono::steady_clock::now();
+        co_await vial::sleep_for(20ms);
+        slept = std::chrono::steady_clock::now() - before;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(sleeper());
+    scheduler.start();
+
+    EXPECT_GE(slept, 20ms);
+}
+
+TEST(SleepIntegration, SleepersWakeInDeadlineOrder) {
+    vial::Scheduler scheduler{1};
+    std::vector<int> order;
+
+    auto sleeper = [&](int id, std::chrono::milliseconds delay) -> vial::Task<void> {
+        co_await vial::sleep_for(delay);
+        order.push_back(id);
+        co_return;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto slow = scheduler.spawn_task(sleeper(3, 30ms));
+        auto fast = scheduler.spawn_task(sleeper(1, 5ms));
+        auto medium = scheduler.spawn_task(sleeper(2, 15ms));
+        co_await slow;
+        co_await fast;
+        co_await medium;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(SleepIntegration, PastDeadlineDoesNotSuspend) {
+    vial::Scheduler scheduler{1};
+    bool done = false;
+
+    auto task = [&]() -> vial::Task<void> {
+        co_await vial::sleep_until(vial::TimerClock::now() - 1s);
+        done = true;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(task());
+    scheduler.start();
+
+    EXPECT_TRUE(done);
+}
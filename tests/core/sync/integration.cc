@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/sync.hh"
+#include "vial/core/task.hh"
+#include "vial/core/task_group.hh"
+
+using namespace std::chrono_literals;
+
+TEST(SyncIntegration, MutexSerialisesCriticalSections) {
+    vial::Scheduler scheduler{2};
+    vial::AsyncMutex mutex;
+    int counter = 0;
+    int inside = 0;
+    bool overlapped = false;
+
+    auto worker = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 10; i++) {
+            auto guard = co_await mutex.scoped_lock();
+            if (++inside > 1) { overlapped = true; }
+            int seen = counter;
+            // Suspend while holding the lock
+            co_await vial::sleep_for(i % 3 == 0 ? 1ms : 0ms);
+            counter = seen + 1;
+            inside--;
+        }
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        for (int i = 0; i < 20; i++) { group.spawn(worker()); }
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(counter, 200);
+    EXPECT_FALSE(overlapped);
+    EXPECT_TRUE(mutex.try_lock());
+}
+
+TEST(SyncIntegration, SemaphoreLimitsConcurrency) {
+    vial::Scheduler scheduler{2};
+    vial::AsyncSemaphore semaphore{3};
+    std::atomic<int> active = 0;
+    std::atomic<int> peak = 0;
+
+    auto worker = [&]() -> vial::Task<void> {
+        co_await semaphore.acquire();
+        int now = ++active;
+        int previous = peak.load();
+        while (now > previous && !peak.compare_exchange_weak(previous, now)) {}
+        co_await vial::sleep_for(2ms);
+        active--;
+        semaphore.release();
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        for (int i = 0; i < 30; i++) { group.spawn(worker()); }
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(peak.load(), 3);
+    EXPECT_EQ(semaphore.available(), 3);
+}
+
+TEST(SyncIntegration, CondVarHandsOffItems) {
+    vial::Scheduler scheduler{2};
+    vial::AsyncMutex mutex;
+    vial::AsyncCondVar ready;
+    std::deque<int> items;
+    bool closed = false;
+    std::atomic<int> consumed = 0;
+    std::atomic<int> sum = 0;
+
+    auto consumer = [&]() -> vial::Task<void> {
+        auto guard = co_await mutex.scoped_lock();
+        while (true) {
+            while (items.empty() && !closed) { co_await ready.wait(mutex); }
+            if (items.empty()) { break; }
+            sum += items.front();
+            items.pop_front();
+            consumed++;
+        }
+    };
+
+    auto producer = [&]() -> vial::Task<void> {
+        for (int i = 1; i <= 100; i++) {
+            {
+                auto guard = co_await mutex.scoped_lock();
+                items.push_back(i);
+            }
+            ready.notify_one();
+            if (i % 10 == 0) { co_await vial::sleep_for(1ms); }
+        }
+        auto guard = co_await mutex.scoped_lock();
+        closed = true;
+        ready.notify_all();
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        for (int i = 0; i < 4; i++) { group.spawn(consumer()); }
+        group.spawn(producer());
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(consumed.load(), 100);
+    EXPECT_EQ(sum.load(), 5050);
+}
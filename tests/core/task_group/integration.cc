@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/task_group.hh"
+
+using namespace std::chrono_literals;
+
+TEST(TaskGroupIntegration, JoinsAllChildren) {
+    vial::Scheduler scheduler{2};
+    std::atomic<int> done = 0;
+    int joined_with = -1;
+
+    auto child = [&](int delay_ms) -> vial::Task<void> {
+        co_await vial::sleep_for(std::chrono::milliseconds(delay_ms));
+        done++;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        for (int i = 0; i < 100; i++) { group.spawn(child(i % 10)); }
+        co_await group.join();
+        joined_with = done.load();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(joined_with, 100);
+}
+
+TEST(TaskGroupIntegration, FailureCancelsSiblings) {
+    vial::Scheduler scheduler{1};
+    vial::WaitStatus sibling_status = vial::WaitStatus::kReady;
+    std::string error;
+    std::chrono::steady_clock::duration elapsed{};
+
+    auto failing = []() -> vial::Task<int> {
+        co_await vial::sleep_for(5ms);
+        throw std::runtime_error("boom");
+    };
+
+    auto sibling = [&]() -> vial::Task<void> {
+        sibling_status = co_await vial::sleep_for(10s);
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto before = std::chrono::steady_clock::now();
+        vial::TaskGroup group{scheduler};
+        group.spawn(sibling());
+        group.spawn(failing());
+        try {
+            co_await group.join();
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        elapsed = std::chrono::steady_clock::now() - before;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(error, "boom");
+    EXPECT_EQ(sibling_status, vial::WaitStatus::kCancelled);
+    EXPECT_LT(elapsed, 5s);
+}
+
+TEST(TaskGroupIntegration, ParentCancellationReachesChildren) {
+    vial::Scheduler scheduler{1};
+    auto token = vial::CancellationToken::create();
+    vial::WaitStatus child_status = vial::WaitStatus::kReady;
+
+    auto child = [&]() -> vial::Task<void> {
+        child_status = co_await vial::sleep_for(10s);
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        group.spawn(child());
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    auto canceller = [&]() -> vial::Task<void> {
+        co_await vial::sleep_for(5ms);
+        token.cancel();
+    };
+
+    auto root = parent();
+    root.set_cancellation_token(token);
+    scheduler.fire_and_forget(root);
+    scheduler.fire_and_forget(canceller());
+    scheduler.start();
+
+    EXPECT_EQ(child_status, vial::WaitStatus::kCancelled);
+}
+
+TEST(TaskGroupIntegration, AwaitRethrowsChildException) {
+    vial::Scheduler scheduler{1};
+    bool caught = false;
+
+    auto failing = []() -> vial::Task<int> {
+        throw std::logic_error("bad");
+        co_return 1;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        try {
+            co_await failing();
+        } catch (const std::logic_error&) {
+            caught = true;
+        }
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_TRUE(caught);
+}
+
+TEST(TaskGroupIntegration, ScopedGroupJoinsWhenBodyThrows) {
+    vial::Scheduler scheduler{1};
+    vial::WaitStatus child_status = vial::WaitStatus::kReady;
+    bool child_done = false;
+    std::string error;
+
+    auto child = [&]() -> vial::Task<void> {
+        child_status = co_await vial::sleep_for(10s);
+        child_done = true;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        try {
+            co_await vial::with_task_group(scheduler, [&](vial::TaskGroup& group) -> vial::Task<void> {
+                group.spawn(child());
+                co_await vial::sleep_for(5ms);
+                throw std::runtime_error("body");
+            });
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        // The child has completed before the helper rethrows
+        EXPECT_TRUE(child_done);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(error, "body");
+    EXPECT_EQ(child_status, vial::WaitStatus::kCancelled);
+}
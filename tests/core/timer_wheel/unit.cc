@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "vial/core/timer_wheel.hh"
+
+using namespace std::chrono_literals;
+
+TEST(TimerWheelUnit, FiresAtDeadline) {
+  const auto start = vial::TimerClock::now();
+  vial::TimerWheel wheel{start};
+
+  vial::TimerEntry entry;
+  bool fired = false;
+  wheel.schedule(entry, start + 5ms, [&]() { fired = true; });
+  EXPECT_TRUE(entry.is_pending());
+  EXPECT_EQ(wheel.size(), 1);
+
+  EXPECT_EQ(wheel.advance(start + 4ms), 0);
+  EXPECT_FALSE(fired);
+
+  EXPECT_EQ(wheel.advance(start + 5ms), 1);
+  EXPECT_TRUE(fired);
+  EXPECT_FALSE(entry.is_pending());
+  EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(TimerWheelUnit, FiresInOrderAcrossLevels) {
+  const auto start = vial::TimerClock::now();
+  vial::TimerWheel wheel{start};
+
+  // One deadline per level, plus some that land exactly on level boundaries
+  const std::vector<std::chrono::milliseconds> delays = {3ms, 64ms, 65ms, 700ms, 4096ms, 5000ms, 300000ms};
+  std::vector<std::unique_ptr<vial::TimerEntry>> entries;
+  std::vector<std::chrono::milliseconds> fired;
+
+  for (auto delay : delays) {
+    entries.push_back(std::make_unique<vial::TimerEntry>());
+    wheel.schedule(*entries.back(), start + delay, [&fired, delay]() { fired.push_back(delay); });
+  }
+
+  // Step one tick at a time so each timer must fire exactly on its own tick
+  for (auto now = 0ms; now <= delays.back(); now += 1ms) {
+    size_t expected = 0;
+    for (auto delay : delays) { expected += delay == now ? 1 : 0; }
+    ASSERT_EQ(wheel.advance(start + now), expected) << "at " << now.count() << "ms";
+  }
+
+  EXPECT_EQ(fired, delays);
+}
+
+TEST(TimerWheelUnit, CancelPreventsFiring) {
+  const auto start = vial::TimerClock::now();
+  vial::TimerWheel wheel{start};
+
+  vial::TimerEntry kept;
+  bool kept_fired = false;
+  wheel.schedule(kept, start + 10ms, [&]() { kept_fired = true; });
+
+  bool cancelled_fired = false;
+  {
+    vial::TimerEntry cancelled;
+    wheel.schedule(cancelled, start + 10ms, [&]() { cancelled_fired = true; });
+    EXPECT_TRUE(cancelled.cancel());
+    EXPECT_FALSE(cancelled.cancel());
+
+    // Destroying a pending entry cancels it too
+    vial::TimerEntry dropped;
+    wheel.schedule(dropped, start + 10ms, [&]() { cancelled_fired = true; });
+  }
+  EXPECT_EQ(wheel.size(), 1);
+
+  EXPECT_EQ(wheel.advance(start + 1s), 1);
+  EXPECT_TRUE(kept_fired);
+  EXPECT_FALSE(cancelled_fired);
+}
+
+TEST(TimerWheelUnit, ManyTimers) {
+  constexpr int count = 100000;
+  const auto start = vial::TimerClock::now();
+  vial::TimerWheel wheel{start};
+
+  std::vector<vial::TimerEntry> entries(count);
+  int fired = 0;
+  for (int i = 0; i < count; i++) {
+    wheel.schedule(entries[i], start + std::chrono::milliseconds(i % 10000), [&]() { fired++; });
+  }
+  EXPECT_EQ(wheel.size(), count);
+
+  // Cancel every other one
+  for (int i = 0; i < count; i += 2) { entries[i].cancel(); }
+
+  wheel.advance(start + 10s);
+  EXPECT_EQ(fired, count / 2);
+  EXPECT_EQ(wheel.size(), 0);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <vector>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/wait_group.hh"
+
+using namespace std::chrono_literals;
+
+TEST(WaitGroupIntegration, JoinsDynamicTaskCount) {
+    vial::Scheduler scheduler{2};
+    vial::WaitGroup group;
+    std::atomic<int> finished = 0;
+    int joined_with = -1;
+
+    auto leaf = [&](int depth) -> vial::Task<void> {
+        co_await vial::sleep_for(std::chrono::milliseconds(depth));
+        finished++;
+        group.done();
+    };
+
+    // Spawns a number of leaves only known once it runs
+    auto fan_out = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 50; i++) {
+            group.add();
+            scheduler.fire_and_forget(leaf(i % 4));
+        }
+        group.done();
+        co_return;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        for (int i = 0; i < 4; i++) {
+            group.add();
+            scheduler.fire_and_forget(fan_out());
+        }
+        co_await group.wait();
+        joined_with = finished.load();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(joined_with, 200);
+    EXPECT_EQ(group.count(), 0);
+}
+
+TEST(WaitGroupIntegration, LatchReleasesAllWaiters) {
+    vial::Scheduler scheduler{2};
+    vial::Latch ready{1};
+    vial::WaitGroup group;
+    std::atomic<int> released = 0;
+
+    auto waiter = [&]() -> vial::Task<void> {
+        co_await ready.wait();
+        released++;
+        group.done();
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        group.add(10);
+        for (int i = 0; i < 10; i++) { scheduler.fire_and_forget(waiter()); }
+        co_await vial::sleep_for(5ms);
+        EXPECT_EQ(released.load(), 0);
+
+        ready.count_down();
+        co_await group.wait();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(released.load(), 10);
+    EXPECT_TRUE(ready.try_wait());
+}
+
+TEST(WaitGroupIntegration, BarrierSeparatesPhases) {
+    vial::Scheduler scheduler{2};
+    constexpr int kTasks = 4;
+    constexpr int kPhases = 5;
+    vial::Barrier barrier{kTasks};
+    vial::WaitGroup group;
+    std::vector<std::atomic<int>> arrivals(kPhases);
+    bool ordered = true;
+
+    auto worker = [&](int id) -> vial::Task<void> {
+        for (int phase = 0; phase < kPhases; phase++) {
+            if (phase > 0 && arrivals[phase - 1].load() != kTasks) { ordered = false; }
+            arrivals[phase]++;
+            co_await vial::sleep_for(std::chrono::milliseconds(id));
+            co_await barrier.arrive_and_wait();
+        }
+        group.done();
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        group.add(kTasks);
+        for (int i = 0; i < kTasks; i++) { scheduler.fire_and_forget(worker(i)); }
+        co_await group.wait();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(barrier.phase(), kPhases);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/task_group.hh"
+#include "vial/core/watch.hh"
+
+using namespace std::chrono_literals;
+
+TEST(WatchIntegration, ReceiverSeesLatestValue) {
+    vial::Scheduler scheduler{2};
+    auto [sender, receiver] = vial::watch<std::string>("v0");
+    std::vector<std::string> seen;
+
+    auto watcher = [&]() -> vial::Task<void> {
+        seen.push_back(receiver.get());
+        while (auto config = co_await receiver.changed()) { seen.push_back(*config); }
+    };
+
+    auto publish = [&]() -> vial::Task<void> {
+        co_await vial::sleep_for(2ms);
+        sender.send("v1");
+        co_await vial::sleep_for(2ms);
+        sender.send("v2");
+        co_await vial::sleep_for(2ms);
+        sender.close();
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        vial::TaskGroup group{scheduler};
+        group.spawn(watcher());
+        group.spawn(publish());
+        co_await group.join();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(seen, (std::vector<std::string>{"v0", "v1", "v2"}));
+}
+
+TEST(WatchIntegration, IntermediateValuesCoalesce) {
+    auto [sender, receiver] = vial::watch<int>(0);
+    EXPECT_FALSE(receiver.has_changed());
+
+    for (int i = 1; i <= 5; i++) { sender.send(i); }
+    EXPECT_TRUE(receiver.has_changed());
+    EXPECT_EQ(receiver.get(), 5);
+    EXPECT_FALSE(receiver.has_changed());
+}
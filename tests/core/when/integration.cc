@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/core/when.hh"
+
+using namespace std::chrono_literals;
+
+TEST(WhenIntegration, AllVariadic) {
+    vial::Scheduler scheduler{2};
+    std::tuple<int, std::string, std::monostate> results;
+
+    auto number = []() -> vial::Task<int> {
+        co_await vial::sleep_for(5ms);
+        co_return 42;
+    };
+
+    auto text = []() -> vial::Task<std::string> {
+        co_return "shard";
+    };
+
+    auto nothing = []() -> vial::Task<void> {
+        co_await vial::sleep_for(1ms);
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        results = co_await vial::when_all(scheduler, number(), text(), nothing());
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(std::get<0>(results), 42);
+    EXPECT_EQ(std::get<1>(results), "shard");
+}
+
+TEST(WhenIntegration, AllRangeKeepsOrder) {
+    vial::Scheduler scheduler{2};
+    std::vector<int> results;
+
+    auto shard = [](int i) -> vial::Task<int> {
+        co_await vial::sleep_for(std::chrono::milliseconds((128 - i) % 7));
+        co_return i * 2;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        std::vector<vial::Task<int>> tasks;
+        for (int i = 0; i < 128; i++) { tasks.push_back(shard(i)); }
+        results = co_await vial::when_all(scheduler, std::move(tasks));
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    ASSERT_EQ(results.size(), 128);
+    for (int i = 0; i < 128; i++) { EXPECT_EQ(results[i], i * 2); }
+}
+
+TEST(WhenIntegration, AllRethrowsChildException) {
+    vial::Scheduler scheduler{1};
+    std::string error;
+    std::atomic<int> finished = 0;
+
+    auto failing = []() -> vial::Task<int> {
+        throw std::runtime_error("boom");
+        co_return 0;
+    };
+
+    auto ok = [&]() -> vial::Task<int> {
+        co_await vial::sleep_for(5ms);
+        finished++;
+        co_return 1;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        try {
+            co_await vial::when_all(scheduler, ok(), failing(), ok());
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(error, "boom");
+    // when_all still waits for every child
+    EXPECT_EQ(finished.load(), 2);
+}
+
+TEST(WhenIntegration, AnyCancelsLosers) {
+    vial::Scheduler scheduler{1};
+    std::pair<size_t, int> winner{};
+    std::atomic<int> cancelled = 0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    auto replica = [&](int delay_ms) -> vial::Task<int> {
+        if (co_await vial::sleep_for(std::chrono::milliseconds(delay_ms)) == vial::WaitStatus::kCancelled) {
+            cancelled++;
+        }
+        co_return delay_ms;
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        auto before = std::chrono::steady_clock::now();
+        std::vector<vial::Task<int>> tasks;
+        tasks.push_back(replica(10000));
+        tasks.push_back(replica(5));
+        tasks.push_back(replica(10000));
+        winner = co_await vial::when_any(scheduler, std::move(tasks));
+        elapsed = std::chrono::steady_clock::now() - before;
+
+        // Give the losers a chance to observe the cancellation
+        co_await vial::sleep_for(5ms);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    EXPECT_EQ(winner.first, 1);
+    EXPECT_EQ(winner.second, 5);
+    EXPECT_EQ(cancelled.load(), 2);
+    EXPECT_LT(elapsed, 1s);
+}
+
+TEST(WhenIntegration, AnyVariadicReportsIndex) {
+    vial::Scheduler scheduler{1};
+    std::variant<int, std::string> winner;
+
+    auto slow = []() -> vial::Task<int> {
+        co_await vial::sleep_for(10s);
+        co_return 1;
+    };
+
+    auto fast = []() -> vial::Task<std::string> {
+        co_return "fast";
+    };
+
+    auto parent = [&]() -> vial::Task<void> {
+        winner = co_await vial::when_any(scheduler, slow(), fast());
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(parent());
+    scheduler.start();
+
+    ASSERT_EQ(winner.index(), 1);
+    EXPECT_EQ(std::get<1>(winner), "fast");
+}
+
+TEST(WhenIntegration, AnyRangeRejectsEmpty) {
+    vial::Scheduler scheduler{1};
+    EXPECT_THROW(vial::when_any(scheduler, std::vector<vial::Task<int>>{}), std::invalid_argument);
+}
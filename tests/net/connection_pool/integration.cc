@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+#include "vial/core/yield.hh"
+#include "vial/net/connection_pool.hh"
+#include "tests/support/io_thread.hh"
+
+namespace {
+
+using vial::test::IOThread;
+
+auto echo_until_closed(vial::net::Socket client) -> vial::Task<void> {
+    std::array<std::byte, 64> buffer{}; // NOLINT
+    while (true) {
+        auto bytes_read = co_await client.read(buffer);
+        if (bytes_read <= 0) { break; }
+        co_await client.write(std::span<const std::byte>(buffer.data(), bytes_read));
+    }
+    co_return;
+}
+
+//! Accept `connections` clients and echo on each until it closes.
+auto serve(vial::Scheduler& scheduler, vial::net::Socket& listener, int connections) -> vial::Task<int> {
+    std::vector<vial::Task<void>> handlers;
+    for (int i = 0; i < connections; i++) {
+        auto client = co_await listener.accept();
+        handlers.push_back(scheduler.spawn_task(echo_until_closed(std::move(client))));
+    }
+    for (auto& handler : handlers) { co_await handler; }
+    co_return connections;
+}
+
+auto round_trip(vial::net::PooledConnection& conn, std::byte value) -> vial::Task<bool> {
+    std::array<std::byte, 1> out{value};
+    std::array<std::byte, 1> in{};
+    if (co_await conn.socket().write(out) != 1) { co_return false; }
+    if (co_await conn.socket().read(in) != 1) { co_return false; }
+    co_return in[0] == value;
+}
+
+} // namespace
+
+TEST(ConnectionPoolIntegration, ReusesIdleConnection) {
+    constexpr int port = 18431;
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto listener = vial::net::listen("127.0.0.1", port);
+    ASSERT_TRUE(listener.is_valid());
+
+    int first_fd = -1;
+    int second_fd = -1;
+    bool echoed = false;
+
+    auto client = [&]() -> vial::Task<void> {
+        auto server = scheduler.spawn_task(serve(scheduler, listener, 1));
+        {
+            vial::net::ConnectionPool pool;
+            {
+                auto conn = co_await pool.acquire("127.0.0.1", port);
+                first_fd = conn.socket().fd();
+                echoed = co_await round_trip(conn, std::byte{1});
+            }
+            {
+                auto conn = co_await pool.acquire("127.0.0.1", port);
+                second_fd = conn.socket().fd();
+                echoed = echoed && co_await round_trip(conn, std::byte{2});
+            }
+        } // pool closes the idle connection
+
+        co_await server;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(client());
+    scheduler.start();
+
+    EXPECT_TRUE(echoed);
+    EXPECT_GE(first_fd, 0);
+    EXPECT_EQ(first_fd, second_fd);
+}
+
+TEST(ConnectionPoolIntegration, WaitsAtMaxPerHost) {
+    constexpr int port = 18432;
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto listener = vial::net::listen("127.0.0.1", port);
+    ASSERT_TRUE(listener.is_valid());
+
+    std::vector<int> order;
+    int fd_a = -1;
+    int fd_b = -1;
+
+    auto client = [&]() -> vial::Task<void> {
+        auto server = scheduler.spawn_task(serve(scheduler, listener, 1));
+        {
+            vial::net::ConnectionPool pool{{.max_per_host = 1, .max_idle_per_host = 1, .num_shards = 1}};
+
+            auto holder = [&]() -> vial::Task<void> {
+                auto conn = co_await pool.acquire("127.0.0.1", port);
+                fd_a = conn.socket().fd();
+                co_await round_trip(conn, std::byte{1});
+                order.push_back(1);
+                co_return;
+            };
+
+            auto waiter = [&]() -> vial::Task<void> {
+                auto conn = co_await pool.acquire("127.0.0.1", port);
+                fd_b = conn.socket().fd();
+                order.push_back(2);
+                co_return;
+            };
+
+            // The newest spawn runs first, so let the holder take the only connection before
+            // the waiter asks for it
+            auto first = scheduler.spawn_task(holder());
+            co_await vial::yield();
+            auto second = scheduler.spawn_task(waiter());
+            co_await first;
+            co_await second;
+        }
+
+        co_await server;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(client());
+    scheduler.start();
+
+    ASSERT_EQ(order.size(), 2);
+    EXPECT_EQ(order[0], 1);
+    EXPECT_EQ(order[1], 2);
+    EXPECT_EQ(fd_a, fd_b);
+}
+
+TEST(ConnectionPoolIntegration, MaxPerHostSpansShards) {
+    using namespace std::chrono_literals;
+    constexpr int port = 18435;
+    IOThread io;
+    vial::Scheduler scheduler{2};
+    auto listener = vial::net::listen("127.0.0.1", port);
+    ASSERT_TRUE(listener.is_valid());
+
+    vial::net::ConnectionPool pool{{.max_per_host = 1, .max_idle_per_host = 1, .num_shards = 2}};
+    std::atomic<bool> acquired = false;
+    std::atomic<bool> waiting = false;
+    std::optional<size_t> worker_a;
+    std::optional<size_t> worker_b;
+    int fd_a = -1;
+    int fd_b = -1;
+
+    // Holds its worker (and so its shard) while the other acquirer hits the cap
+    auto holder = [&]() -> vial::Task<void> {
+        auto conn = co_await pool.acquire("127.0.0.1", port);
+        fd_a = conn.socket().fd();
+        worker_a = scheduler.current_worker();
+        acquired = true;
+        while (!waiting) {}
+        std::this_thread::sleep_for(20ms);
+        co_return;
+    };
+
+    auto waiter = [&]() -> vial::Task<void> {
+        while (!acquired) {}
+        worker_b = scheduler.current_worker();
+        waiting = true;
+        auto conn = co_await pool.acquire("127.0.0.1", port);
+        fd_b = conn.socket().fd();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(holder());
+    scheduler.fire_and_forget(waiter());
+    scheduler.start();
+
+    EXPECT_NE(worker_a, worker_b);
+    EXPECT_GE(fd_a, 0);
+    EXPECT_EQ(fd_a, fd_b);
+}
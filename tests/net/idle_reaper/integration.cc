@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/net/idle_reaper.hh"
+#include "tests/support/io_thread.hh"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using vial::test::IOThread;
+
+} // namespace
+
+TEST(IdleReaperIntegration, ShutsDownIdleSocket) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+
+    vial::net::IdleReaper reaper{40ms};
+    reaper.watch(right);
+    EXPECT_EQ(reaper.size(), 1);
+
+    ssize_t read_result = -1;
+    std::chrono::steady_clock::duration waited{};
+    auto test = [&]() -> vial::Task<void> {
+        auto before = std::chrono::steady_clock::now();
+        std::array<std::byte, 1> in{};
+        read_result = co_await right.read(in);
+        waited = std::chrono::steady_clock::now() - before;
+
+        reaper.stop();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(reaper.run());
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(read_result, 0);
+    EXPECT_GE(waited, 40ms);
+}
+
+TEST(IdleReaperIntegration, KeepsActiveSocket) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+
+    vial::net::IdleReaper reaper{40ms};
+    reaper.watch(right);
+
+    int received = 0;
+    auto test = [&]() -> vial::Task<void> {
+        std::array<std::byte, 1> buffer{std::byte{1}};
+        for (int i = 0; i < 12; i++) {
+            co_await left.write(buffer);
+            if (co_await right.read(buffer) == 1) { received++; }
+            co_await vial::sleep_for(10ms);
+        }
+
+        reaper.stop();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(reaper.run());
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(received, 12);
+}
+
+TEST(IdleReaperIntegration, ForgetsClosedSocket) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+
+    vial::net::IdleReaper reaper{16ms};
+    {
+        auto [left, right] = vial::net::socketpair();
+        reaper.watch(right);
+    }
+    EXPECT_EQ(reaper.size(), 1);
+
+    auto test = [&]() -> vial::Task<void> {
+        co_await vial::sleep_for(40ms);
+        reaper.stop();
+        scheduler.stop();
+    };
+
+    size_t watched = 1;
+    auto check = [&]() -> vial::Task<void> {
+        co_await vial::sleep_for(30ms);
+        watched = reaper.size();
+    };
+
+    scheduler.fire_and_forget(reaper.run());
+    scheduler.fire_and_forget(check());
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(watched, 0);
+}
@@ -0,0 +1,471 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "vial/core/budget.hh"
+#include "vial/core/scheduler.hh"
+#include "vial/core/sleep.hh"
+#include "vial/core/task.hh"
+#include "vial/net/socket.hh"
+#include "tests/support/io_thread.hh"
+
+namespace {
+
+using vial::test::IOThread;
+
+auto send_byte(const vial::net::Socket& socket, std::byte value) -> vial::Task<bool> {
+    std::array<std::byte, 1> out{value};
+    co_return co_await socket.write(out) == 1;
+}
+
+auto recv_byte(const vial::net::Socket& socket) -> vial::Task<int> {
+    std::array<std::byte, 1> in{};
+    if (co_await socket.read(in) != 1) { co_return -1; }
+    co_return static_cast<int>(in[0]);
+}
+
+auto read_exactly(const vial::net::Socket& socket, size_t size) -> vial::Task<std::vector<std::byte>> {
+    std::vector<std::byte> data(size);
+    size_t received = 0;
+    while (received < size) {
+        ssize_t ret = co_await socket.read(std::span(data).subspan(received));
+        if (ret <= 0) { break; }
+        received += static_cast<size_t>(ret);
+    }
+    data.resize(received);
+    co_return data;
+}
+
+auto make_payload(size_t size) -> std::vector<std::byte> {
+    std::vector<std::byte> payload(size);
+    for (size_t i = 0; i < size; i++) { payload[i] = static_cast<std::byte>(i * 31 + i / 251); }
+    return payload;
+}
+
+} // namespace
+
+TEST(SocketIntegration, SocketPairRoundTrip) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+    ASSERT_TRUE(left.is_valid());
+    ASSERT_TRUE(right.is_valid());
+
+    int received = -1;
+    auto test = [&]() -> vial::Task<void> {
+        co_await send_byte(left, std::byte{42});
+        received = co_await recv_byte(right);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(received, 42);
+}
+
+TEST(SocketIntegration, LeasedRead) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+
+    size_t received = 0;
+    int eof_error = -1;
+    auto test = [&]() -> vial::Task<void> {
+        std::array<std::byte, 3> out{std::byte{1}, std::byte{2}, std::byte{3}};
+        co_await left.write(out);
+
+        auto buffer = co_await right.read();
+        received = buffer.size();
+
+        left = vial::net::Socket{};
+        auto eof = co_await right.read();
+        eof_error = eof.empty() ? eof.error() : -1;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(received, 3);
+    EXPECT_EQ(eof_error, 0);
+}
+
+TEST(SocketIntegration, AlwaysReadableSocketYieldsWhenBudgetRunsOut) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+
+    // Enough queued data that no read ever has to wait
+    constexpr int kReads = 3 * static_cast<int>(vial::kTaskBudget);
+    std::vector<std::byte> payload(kReads, std::byte{7});
+    ASSERT_EQ(::write(left.fd(), payload.data(), payload.size()), kReads);
+
+    int reads = 0;
+    int reads_when_other_ran = -1;
+    uint32_t budget_after_first_read = 0;
+    auto reader = [&]() -> vial::Task<void> {
+        std::array<std::byte, 1> in{};
+        for (; reads < kReads; reads++) {
+            if (co_await right.read(in) != 1) { break; }
+            if (reads == 0) { budget_after_first_read = vial::CoopBudget::remaining(); }
+        }
+        scheduler.stop();
+    };
+    auto other = [&]() -> vial::Task<void> {
+        reads_when_other_ran = reads;
+        co_return;
+    };
+
+    scheduler.fire_and_forget(reader());
+    scheduler.fire_and_forget(other());
+    scheduler.start();
+
+    EXPECT_EQ(reads, kReads);
+    EXPECT_EQ(budget_after_first_read, vial::kTaskBudget - 1);
+    EXPECT_GT(reads_when_other_ran, 0);
+    EXPECT_LE(reads_when_other_ran, static_cast<int>(vial::kTaskBudget));
+}
+
+TEST(SocketIntegration, MultishotRecv) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+    right.enable_multishot_recv();
+
+    int first = -1;
+    size_t rest = 0;
+    bool eof = false;
+    auto test = [&]() -> vial::Task<void> {
+        std::array<std::byte, 3> out{std::byte{1}, std::byte{2}, std::byte{3}};
+        co_await left.write(out);
+
+        // A partial read leaves the remainder of the completion queued
+        first = co_await recv_byte(right);
+        auto buffer = co_await right.read();
+        rest = buffer.size();
+
+        left = vial::net::Socket{};
+        auto last = co_await right.read();
+        eof = last.empty() && last.error() == 0;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(rest, 2);
+    EXPECT_TRUE(eof);
+}
+
+TEST(SocketIntegration, MultishotRecvResumesAfterFullRing) {
+    using namespace std::chrono_literals;
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [left, right] = vial::net::socketpair();
+    right.enable_multishot_recv(16);
+
+    // More than the ring holds, so reads pause until the reader drains it
+    auto payload = make_payload(vial::net::kRecvRingSize * 16 * 4);
+    std::vector<std::byte> received;
+    auto test = [&]() -> vial::Task<void> {
+        co_await left.write(payload);
+        co_await vial::sleep_for(20ms);
+        received = co_await read_exactly(right, payload.size());
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(received, payload);
+}
+
+TEST(SocketIntegration, UnixListenConnect) {
+    const char* path = "/tmp/vial_socket_integration.sock";
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto listener = vial::net::listen_unix(path);
+    ASSERT_TRUE(listener.is_valid());
+
+    int received = -1;
+    auto test = [&]() -> vial::Task<void> {
+        auto client = co_await vial::net::connect_unix(path);
+        auto server = co_await listener.accept();
+        co_await send_byte(client, std::byte{7});
+        received = co_await recv_byte(server);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(received, 7);
+    ::unlink(path);
+}
+
+TEST(SocketIntegration, UnixListenReplacesOnlyStaleSockets) {
+    const char* path = "/tmp/vial_socket_integration_stale.sock";
+    ::unlink(path);
+
+    // A regular file is left alone
+    int file = ::open(path, O_CREAT | O_WRONLY, 0600); // NOLINT
+    ASSERT_GE(file, 0);
+    ::close(file);
+    auto over_file = vial::net::listen_unix(path);
+    EXPECT_FALSE(over_file.is_valid());
+    EXPECT_EQ(errno, EADDRINUSE);
+    struct stat info{};
+    ASSERT_EQ(::lstat(path, &info), 0);
+    EXPECT_TRUE(S_ISREG(info.st_mode));
+    ::unlink(path);
+
+    // So is a socket someone is listening on
+    auto live = vial::net::listen_unix(path);
+    ASSERT_TRUE(live.is_valid());
+    auto over_live = vial::net::listen_unix(path);
+    EXPECT_FALSE(over_live.is_valid());
+    EXPECT_EQ(errno, EADDRINUSE);
+
+    // Once its owner is gone the socket file is stale and gets replaced
+    live = vial::net::Socket{};
+    auto replaced = vial::net::listen_unix(path);
+    EXPECT_TRUE(replaced.is_valid());
+    ::unlink(path);
+}
+
+TEST(SocketIntegration, UnixListenDoesNotBlockOnAFullBacklog) {
+    const char* path = "/tmp/vial_socket_integration_backlog.sock";
+    ::unlink(path);
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)), 0); // NOLINT
+    ASSERT_EQ(::listen(listener, 0), 0);
+
+    // Fill the backlog, so a blocking connect to it would wait for an accept that never comes
+    std::vector<int> clients;
+    while (true) {
+        int client = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        ASSERT_GE(client, 0);
+        clients.push_back(client);
+        if (::connect(client, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) { // NOLINT
+            ASSERT_EQ(errno, EAGAIN);
+            break;
+        }
+    }
+
+    auto over_live = vial::net::listen_unix(path);
+    EXPECT_FALSE(over_live.is_valid());
+    EXPECT_EQ(errno, EADDRINUSE);
+
+    for (int client : clients) { ::close(client); }
+    ::close(listener);
+    ::unlink(path);
+}
+
+TEST(SocketIntegration, PassFileDescriptor) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto [control_a, control_b] = vial::net::socketpair();
+    auto [passed, kept] = vial::net::socketpair();
+
+    int received = -1;
+    auto test = [&]() -> vial::Task<void> {
+        co_await control_a.send_fd(passed.fd());
+        vial::net::Socket handed_off{co_await control_b.recv_fd()};
+
+        // The received descriptor refers to the same socket as `passed`
+        co_await send_byte(handed_off, std::byte{9});
+        received = co_await recv_byte(kept);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(received, 9);
+}
+
+TEST(SocketIntegration, ReadDeadline) {
+    using namespace std::chrono_literals;
+    IOThread io;
+    // More than one worker: the error must not depend on the resuming thread's errno
+    vial::Scheduler scheduler{2};
+    auto [left, right] = vial::net::socketpair();
+
+    ssize_t timed_out = 0;
+    int received = -1;
+    auto test = [&]() -> vial::Task<void> {
+        std::array<std::byte, 1> in{};
+        timed_out = co_await right.read(in, vial::TimerClock::now() + 20ms);
+
+        // The timed out wait must not linger in the event loop and swallow this one
+        auto sender = [&]() -> vial::Task<void> {
+            co_await vial::sleep_for(5ms);
+            co_await send_byte(left, std::byte{7});
+        };
+        auto send = scheduler.spawn_task(sender());
+        if (co_await right.read(in, vial::TimerClock::now() + 5s) == 1) { received = static_cast<int>(in[0]); }
+        co_await send;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(timed_out, -ETIMEDOUT);
+    EXPECT_EQ(received, 7);
+}
+
+TEST(SocketIntegration, AcceptDeadline) {
+    using namespace std::chrono_literals;
+    IOThread io;
+    vial::Scheduler scheduler{2};
+    auto listener = vial::net::listen("127.0.0.1", 18433);
+    ASSERT_TRUE(listener.is_valid());
+
+    bool valid = true;
+    int accept_error = 0;
+    auto test = [&]() -> vial::Task<void> {
+        auto client = co_await listener.accept(vial::TimerClock::now() + 10ms);
+        valid = client.is_valid();
+        accept_error = client.error();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_FALSE(valid);
+    EXPECT_EQ(accept_error, ETIMEDOUT);
+}
+
+TEST(SocketIntegration, ConnectReportsErrorInBand) {
+    IOThread io;
+    vial::Scheduler scheduler{2};
+
+    // Nothing listens on port 1
+    bool valid = true;
+    int connect_error = 0;
+    auto test = [&]() -> vial::Task<void> {
+        auto client = co_await vial::net::connect("127.0.0.1", 1);
+        valid = client.is_valid();
+        connect_error = client.error();
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_FALSE(valid);
+    EXPECT_EQ(connect_error, ECONNREFUSED);
+}
+
+TEST(SocketIntegration, CancelPendingRead) {
+    using namespace std::chrono_literals;
+    IOThread io;
+    vial::Scheduler scheduler{2};
+    auto [left, right] = vial::net::socketpair();
+    auto token = vial::CancellationToken::create();
+
+    ssize_t cancelled = 0;
+    int received = -1;
+
+    auto reader = [&]() -> vial::Task<void> {
+        std::array<std::byte, 1> in{};
+        cancelled = co_await right.read(in);
+    };
+
+    auto test = [&]() -> vial::Task<void> {
+        auto pending = reader();
+        pending.set_cancellation_token(token);
+        scheduler.spawn_task(pending);
+
+        co_await vial::sleep_for(10ms);
+        token.cancel();
+        co_await pending;
+
+        // The cancelled wait was withdrawn, so a new reader gets the data
+        co_await send_byte(left, std::byte{9});
+        received = co_await recv_byte(right);
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(cancelled, -ECANCELED);
+    EXPECT_EQ(received, 9);
+}
+
+TEST(SocketIntegration, ZerocopySendOverLoopback) {
+    constexpr int port = 18434;
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto listener = vial::net::listen("127.0.0.1", port);
+    ASSERT_TRUE(listener.is_valid());
+
+    // Larger than the send buffer, so it takes several MSG_ZEROCOPY sends with waits in between
+    const auto payload = make_payload(4 * 1024 * 1024);
+    ssize_t sent = 0;
+    uint32_t pending_after = 1;
+    std::vector<std::byte> received;
+
+    auto test = [&]() -> vial::Task<void> {
+        auto client = co_await vial::net::connect("127.0.0.1", port);
+        auto server = co_await listener.accept();
+        int sndbuf = 64 * 1024;
+        setsockopt(client.fd(), SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+        auto reader = scheduler.spawn_task(read_exactly(server, payload.size()));
+        sent = co_await client.send_zerocopy(payload);
+        pending_after = client.zerocopy_pending();
+        received = co_await reader;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(sent, static_cast<ssize_t>(payload.size()));
+    EXPECT_EQ(pending_after, 0U);
+    EXPECT_TRUE(received == payload);
+}
+
+TEST(SocketIntegration, ZerocopyFallsBackWithoutSoZerocopy) {
+    IOThread io;
+    vial::Scheduler scheduler{1};
+
+    // Unix domain sockets don't support SO_ZEROCOPY
+    auto [left, right] = vial::net::socketpair();
+    const auto payload = make_payload(2 * vial::net::kZerocopyThreshold);
+    ssize_t sent = 0;
+    std::vector<std::byte> received;
+
+    auto test = [&]() -> vial::Task<void> {
+        auto reader = scheduler.spawn_task(read_exactly(right, payload.size()));
+        sent = co_await left.send_zerocopy(payload);
+        received = co_await reader;
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(sent, static_cast<ssize_t>(payload.size()));
+    EXPECT_EQ(left.zerocopy_pending(), 0U);
+    EXPECT_TRUE(received == payload);
+}
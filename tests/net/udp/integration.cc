@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <array>
+#include <thread>
+#include <vector>
+
+#include "vial/core/scheduler.hh"
+#include "vial/core/task.hh"
+#include "vial/net/udp_socket.hh"
+#include "tests/support/io_thread.hh"
+
+namespace {
+
+using vial::test::IOThread;
+
+auto loopback(int port) -> sockaddr_in {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+//! Receive into `slots` until `bytes` payload bytes have arrived. Returns the filled slots.
+auto recv_bytes(const vial::net::UdpSocket& socket, std::vector<vial::net::RecvDatagram>& slots, size_t bytes)
+    -> vial::Task<size_t> {
+    size_t filled = 0;
+    size_t total = 0;
+    while (total < bytes && filled < slots.size()) {
+        int ret = co_await socket.recv_batch(std::span(slots).subspan(filled));
+        if (ret <= 0) { break; }
+        for (int i = 0; i < ret; i++) { total += slots[filled + i].size; }
+        filled += static_cast<size_t>(ret);
+    }
+    co_return filled;
+}
+
+//! Send 4 x 1000 bytes as a single GSO send and receive them into `slots`, with or without GRO.
+auto gso_round_trip(bool gro, std::vector<vial::net::RecvDatagram>& slots, size_t& filled) -> void {
+    constexpr int sender_port = 18453;
+    constexpr int receiver_port = 18454;
+    constexpr uint16_t segment_size = 1000;
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto sender = vial::net::bind_udp("127.0.0.1", sender_port);
+    auto receiver = vial::net::bind_udp("127.0.0.1", receiver_port);
+    ASSERT_TRUE(sender.is_valid());
+    ASSERT_TRUE(receiver.is_valid());
+    if (gro) { ASSERT_TRUE(receiver.enable_gro()); }
+
+    std::vector<std::byte> payload(4 * segment_size, std::byte{5});
+    int sent = 0;
+
+    auto test = [&]() -> vial::Task<void> {
+        std::array<vial::net::SendDatagram, 1> batch{{{payload, loopback(receiver_port), segment_size}}};
+        sent = co_await sender.send_batch(batch);
+        filled = co_await recv_bytes(receiver, slots, payload.size());
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    ASSERT_EQ(sent, 1);
+}
+
+} // namespace
+
+TEST(UdpIntegration, BatchRoundTrip) {
+    constexpr int first_port = 18450;
+    constexpr int second_port = 18451;
+    constexpr int receiver_port = 18452;
+    IOThread io;
+    vial::Scheduler scheduler{1};
+    auto first = vial::net::bind_udp("127.0.0.1", first_port);
+    auto second = vial::net::bind_udp("127.0.0.1", second_port);
+    auto receiver = vial::net::bind_udp("127.0.0.1", receiver_port);
+    ASSERT_TRUE(first.is_valid());
+    ASSERT_TRUE(second.is_valid());
+    ASSERT_TRUE(receiver.is_valid());
+
+    std::vector<std::byte> small(10, std::byte{1});
+    std::vector<std::byte> medium(300, std::byte{2});
+    std::vector<std::byte> large(1200, std::byte{3});
+
+    std::vector<std::array<std::byte, 2048>> buffers(8);
+    std::vector<vial::net::RecvDatagram> slots(buffers.size());
+    for (size_t i = 0; i < slots.size(); i++) { slots[i].buffer = buffers[i]; }
+
+    int sent_first = 0;
+    int sent_second = 0;
+    size_t filled = 0;
+
+    auto test = [&]() -> vial::Task<void> {
+        auto to = loopback(receiver_port);
+        std::array<vial::net::SendDatagram, 3> batch{{{small, to}, {medium, to}, {large, to}}};
+        sent_first = co_await first.send_batch(batch);
+        std::array<vial::net::SendDatagram, 1> single{{{medium, to}}};
+        sent_second = co_await second.send_batch(single);
+
+        filled = co_await recv_bytes(receiver, slots, small.size() + 2 * medium.size() + large.size());
+        scheduler.stop();
+    };
+
+    scheduler.fire_and_forget(test());
+    scheduler.start();
+
+    EXPECT_EQ(sent_first, 3);
+    EXPECT_EQ(sent_second, 1);
+    ASSERT_EQ(filled, 4U);
+
+    // Loopback delivers in send order
+    const std::array<size_t, 4> sizes{small.size(), medium.size(), large.size(), medium.size()};
+    const std::array<int, 4> ports{first_port, first_port, first_port, second_port};
+    for (size_t i = 0; i < filled; i++) {
+        EXPECT_EQ(slots[i].size, sizes[i]);
+        EXPECT_EQ(slots[i].segment_size, 0);
+        EXPECT_EQ(ntohs(slots[i].peer.sin_port), ports[i]);
+        EXPECT_EQ(slots[i].peer.sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+    }
+    EXPECT_EQ(buffers[2][0], std::byte{3});
+}
+
+TEST(UdpIntegration, GsoSendWithoutGroArrivesAsSegments) {
+    std::vector<std::array<std::byte, 2048>> buffers(8);
+    std::vector<vial::net::RecvDatagram> slots(buffers.size());
+    for (size_t i = 0; i < slots.size(); i++) { slots[i].buffer = buffers[i]; }
+    size_t filled = 0;
+
+    gso_round_trip(false, slots, filled);
+
+    ASSERT_EQ(filled, 4U);
+    for (size_t i = 0; i < filled; i++) {
+        EXPECT_EQ(slots[i].size, 1000U);
+        EXPECT_EQ(slots[i].segment_size, 0);
+    }
+}
+
+TEST(UdpIntegration, GsoSendWithGroArrivesCoalesced) {
+    std::vector<std::byte> buffer(64 * 1024);
+    std::vector<vial::net::RecvDatagram> slots(1);
+    slots[0].buffer = buffer;
+    size_t filled = 0;
+
+    gso_round_trip(true, slots, filled);
+
+    ASSERT_EQ(filled, 1U);
+    EXPECT_EQ(slots[0].size, 4000U);
+    EXPECT_EQ(slots[0].segment_size, 1000);
+}
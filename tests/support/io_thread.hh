@@ -0,0 +1,26 @@
+#pragma once
+
+#include <thread>
+
+#include "vial/core/io/io_event_loop.hh"
+
+namespace vial::test {
+
+//! Runs the IOEventLoop for the lifetime of the object.
+class IOThread {
+  public:
+    IOThread() : thread_([]() { vial::IOEventLoop::instance().run(); }) {}
+    IOThread(const IOThread&) = delete;
+    IOThread(IOThread&&) = delete;
+    auto operator=(const IOThread&) -> IOThread& = delete;
+    auto operator=(IOThread&&) -> IOThread& = delete;
+    ~IOThread() {
+        vial::IOEventLoop::instance().stop();
+        thread_.join();
+    }
+
+  private:
+    std::thread thread_;
+};
+
+} // namespace vial::test
@@ -32,10 +32,20 @@ namespace vial {
         return scheduler.spawn_task(task);
     }
 
+    template <typename T>
+    auto spawn(Task<T> task, TaskPriority priority) -> Task<T> {
+        return scheduler.spawn_task(task, priority);
+    }
+
     template <typename T>
     auto fire_and_forget(Task<T> task) -> void {
         scheduler.fire_and_forget(task);
     }
+
+    template <typename T>
+    auto fire_and_forget(Task<T> task, TaskPriority priority) -> void {
+        scheduler.fire_and_forget(task, priority);
+    }
 }
 
 auto main () -> int {
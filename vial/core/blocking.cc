@@ -0,0 +1,60 @@
+#include "blocking.hh"
+#include <thread>
+
+namespace vial {
+
+BlockingPool::~BlockingPool() {
+    std::unique_lock guard(lock_);
+    stopping_ = true;
+    jobs_.clear();
+    work_.notify_all();
+    exited_.wait(guard, [this]() { return threads_ == 0; });
+}
+
+void BlockingPool::submit(std::function<void()> job) {
+    std::lock_guard guard(lock_);
+    jobs_.push_back(std::move(job));
+
+    // Queued jobs beyond the idle threads would wait behind another blocking call
+    if (jobs_.size() > idle_ && threads_ < kMaxBlockingThreads) {
+        threads_++;
+        std::thread(&BlockingPool::run_thread, this).detach();
+    } else {
+        work_.notify_one();
+    }
+}
+
+auto BlockingPool::threads() -> size_t {
+    std::lock_guard guard(lock_);
+    return threads_;
+}
+
+void BlockingPool::run_thread() {
+    std::unique_lock guard(lock_);
+    while (!stopping_) {
+        if (jobs_.empty()) {
+            idle_++;
+            bool woken = work_.wait_for(guard, kBlockingIdleTimeout, [this]() { return stopping_ || !jobs_.empty(); });
+            idle_--;
+            if (!woken) { break; }
+            continue;
+        }
+
+        auto job = std::move(jobs_.front());
+        jobs_.pop_front();
+
+        guard.unlock();
+        job();
+        guard.lock();
+    }
+
+    threads_--;
+    exited_.notify_all();
+}
+
+auto BlockingPool::instance() -> BlockingPool& {
+    static BlockingPool instance_;
+    return instance_;
+}
+
+} // namespace vial
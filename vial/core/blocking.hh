@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "io/io_awaitables.hh"
+#include "task.hh"
+
+namespace vial {
+
+//! Maximum number of threads the BlockingPool grows to.
+constexpr size_t kMaxBlockingThreads = 512;
+
+//! How long an idle BlockingPool thread waits for work before exiting.
+constexpr auto kBlockingIdleTimeout = std::chrono::seconds(10);
+
+//! Elastic thread pool for blocking calls (file IO, getaddrinfo, compression, ...) that would
+//! otherwise stall a Scheduler worker. A thread is started whenever a job arrives and none is
+//! idle, up to kMaxBlockingThreads; threads idle for kBlockingIdleTimeout exit.
+class BlockingPool {
+  public:
+    BlockingPool() = default;
+
+    BlockingPool(const BlockingPool&) = delete;
+    BlockingPool(BlockingPool&&) = delete;
+    auto operator=(const BlockingPool&) -> BlockingPool& = delete;
+    auto operator=(BlockingPool&&) -> BlockingPool& = delete;
+
+    //! Waits for the running jobs and stops every thread. Queued jobs are dropped.
+    ~BlockingPool();
+
+    //! Run `job` on a pool thread.
+    void submit(std::function<void()> job);
+
+    //! Number of live pool threads.
+    [[nodiscard]] auto threads() -> size_t;
+
+    // Singleton access (for now)
+    static auto instance() -> BlockingPool&;
+
+  private:
+    void run_thread();
+
+    std::mutex lock_;
+    std::condition_variable work_;
+    std::condition_variable exited_;
+    std::deque<std::function<void()>> jobs_;
+
+    size_t threads_ = 0;
+    size_t idle_ = 0;
+    bool stopping_ = false;
+};
+
+//! Awaitable that runs `fn` on the BlockingPool and resumes the task with its result.
+template <typename F>
+struct BlockingCall {
+    using Result = std::invoke_result_t<F&>;
+
+    //! Registered with the pool while the task is suspended
+    struct Job : IOAwaitable {
+        BlockingCall* origin;
+
+        explicit Job(BlockingCall* call) : origin(call) {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Job(origin); }
+
+        void register_with_event_loop(std::function<void()> callback) override {
+            BlockingPool::instance().submit([call = origin, resume = std::move(callback)]() {
+                call->invoke();
+                resume();
+            });
+        }
+    };
+
+    F fn;
+    std::optional<std::conditional_t<std::is_void_v<Result>, bool, Result>> result;
+    std::exception_ptr exception;
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) noexcept {
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = new Job(this);
+    }
+
+    auto await_resume() -> Result {
+        if (exception) { std::rethrow_exception(exception); }
+        if constexpr (!std::is_void_v<Result>) { return std::move(*result); }
+    }
+
+    //! Runs on the pool thread
+    void invoke() noexcept {
+        try {
+            if constexpr (std::is_void_v<Result>) {
+                fn();
+                result.emplace(true);
+            } else {
+                result.emplace(fn());
+            }
+        } catch (...) {
+            exception = std::current_exception();
+        }
+    }
+};
+
+//! Run the blocking callable `fn` on the BlockingPool, so the Scheduler worker stays free.
+//! The awaiting task is resumed on the worker it suspended on, with `fn`'s result (or its
+//! exception rethrown). e.g. `auto data = co_await spawn_blocking([&] { return read_file(path); });`
+template <typename F>
+auto spawn_blocking(F fn) -> Task<std::invoke_result_t<F&>> {
+    co_return co_await BlockingCall<F>{std::move(fn), std::nullopt, nullptr};
+}
+
+} // namespace vial
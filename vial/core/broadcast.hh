@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "io/io_awaitables.hh"
+#include "sync.hh"
+
+namespace vial {
+
+//! Ring shared by a BroadcastSender and its receivers. Slots are allocated once up front;
+//! `tail` counts every value ever sent, so position `p` lives in slot `p % capacity` until
+//! `capacity` newer values overwrite it.
+template <typename T>
+struct BroadcastState {
+    explicit BroadcastState(size_t size) : capacity(size < 1 ? 1 : size), slots(capacity) {}
+
+    const size_t capacity;
+
+    std::mutex lock;
+    std::vector<std::optional<T>> slots;
+
+    std::atomic<uint64_t> tail = 0;
+    std::atomic<bool> closed = false;
+
+    AsyncWaitQueue waiters;
+};
+
+template <typename T>
+class BroadcastSender;
+
+//! Receiving end of a broadcast channel. Every receiver sees every value sent after it
+//! subscribed, unless it falls more than `capacity` values behind: it then skips ahead to the
+//! oldest value still buffered and the skipped count is added to `missed()`.
+template <typename T>
+class BroadcastReceiver {
+  public:
+    BroadcastReceiver(std::shared_ptr<BroadcastState<T>> state, uint64_t next)
+        : state_(std::move(state)), next_(next) {}
+
+    //! Number of values this receiver lost by lagging behind the sender.
+    [[nodiscard]] auto missed() const noexcept -> uint64_t { return missed_; }
+
+    //! Receive the next value without suspending.
+    auto try_recv() -> std::optional<T> {
+        if (next_ == state_->tail.load()) { return std::nullopt; }
+        return read();
+    }
+
+    //! Awaitable yielding the next value, or std::nullopt once the sender is gone and this
+    //! receiver has seen everything.
+    struct Recv {
+        //! Parked until the sender moves past `next`
+        struct Node : AsyncWaiter {
+            BroadcastReceiver* receiver;
+
+            explicit Node(BroadcastReceiver* origin) : receiver(origin) {}
+
+            [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Node(receiver); }
+
+            void register_with_event_loop(std::function<void()> callback) override {
+                auto state = receiver->state_;
+                resume = std::move(callback);
+                state->waiters.push(this);
+
+                // A value may have been sent before this receiver was visible
+                state->waiters.drain_matching(ready);
+            }
+        };
+
+        BroadcastReceiver* receiver;
+
+        [[nodiscard]] auto await_ready() const noexcept -> bool {
+            return receiver->next_ != receiver->state_->tail.load() || receiver->state_->closed.load();
+        }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = new Node(receiver);
+        }
+
+        auto await_resume() -> std::optional<T> { return receiver->read(); }
+    };
+
+    //! e.g. `while (auto update = co_await receiver.recv()) { ... }`
+    [[nodiscard]] auto recv() -> Recv { return Recv{this}; }
+
+  private:
+    friend class BroadcastSender<T>;
+
+    //! Whether a parked receiver has something to read (run under the wait queue lock).
+    static auto ready(AsyncWaiter& waiter) -> bool {
+        auto* receiver = static_cast<typename Recv::Node&>(waiter).receiver;
+        return receiver->next_ != receiver->state_->tail.load() || receiver->state_->closed.load();
+    }
+
+    //! Copy out the value at `next_`, skipping ahead if it was overwritten.
+    auto read() -> std::optional<T> {
+        std::lock_guard guard(state_->lock);
+        uint64_t tail = state_->tail.load();
+        if (tail - next_ > state_->capacity) {
+            missed_ += tail - state_->capacity - next_;
+            next_ = tail - state_->capacity;
+        }
+        if (next_ == tail) { return std::nullopt; }
+        return state_->slots[next_++ % state_->capacity];
+    }
+
+    std::shared_ptr<BroadcastState<T>> state_;
+    uint64_t next_;
+    uint64_t missed_ = 0;
+};
+
+//! Sending end of a broadcast channel. Sends never wait for receivers: a slow receiver lags
+//! instead of applying backpressure. Destroying the sender closes the channel.
+template <typename T>
+class BroadcastSender {
+  public:
+    explicit BroadcastSender(size_t capacity) : state_(std::make_shared<BroadcastState<T>>(capacity)) {}
+
+    BroadcastSender(BroadcastSender&&) noexcept = default;
+    auto operator=(BroadcastSender&& other) noexcept -> BroadcastSender& {
+        if (this != &other) {
+            close();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+
+    BroadcastSender(const BroadcastSender&) = delete;
+    auto operator=(const BroadcastSender&) -> BroadcastSender& = delete;
+
+    ~BroadcastSender() { close(); }
+
+    //! Publish `value` to every receiver.
+    void send(T value) {
+        {
+            std::lock_guard guard(state_->lock);
+            uint64_t tail = state_->tail.load();
+            state_->slots[tail % state_->capacity] = std::move(value);
+            state_->tail.store(tail + 1);
+        }
+        wake();
+    }
+
+    //! New receiver that sees values sent from now on.
+    [[nodiscard]] auto subscribe() const -> BroadcastReceiver<T> {
+        return BroadcastReceiver<T>{state_, state_->tail.load()};
+    }
+
+    //! Let receivers finish once they have read everything sent so far.
+    void close() {
+        if (state_ == nullptr || state_->closed.exchange(true)) { return; }
+        wake();
+    }
+
+  private:
+    void wake() {
+        if (state_->waiters.waiting() > 0) {
+            state_->waiters.drain_matching(BroadcastReceiver<T>::ready);
+        }
+    }
+
+    std::shared_ptr<BroadcastState<T>> state_;
+};
+
+//! Create a broadcast channel buffering the last `capacity` values, with a first receiver.
+//! More receivers come from `sender.subscribe()`, e.g. to fan out config updates.
+template <typename T>
+auto broadcast(size_t capacity) -> std::pair<BroadcastSender<T>, BroadcastReceiver<T>> {
+    BroadcastSender<T> sender{capacity};
+    BroadcastReceiver<T> receiver = sender.subscribe();
+    return {std::move(sender), std::move(receiver)};
+}
+
+} // namespace vial
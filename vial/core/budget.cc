@@ -0,0 +1,25 @@
+#include "budget.hh"
+
+namespace vial {
+
+namespace {
+
+thread_local uint32_t budget = kTaskBudget;
+
+} // namespace
+
+auto CoopBudget::consume() -> bool {
+    if (budget == 0) { return false; }
+    budget--;
+    return true;
+}
+
+void CoopBudget::reset() {
+    budget = kTaskBudget;
+}
+
+auto CoopBudget::remaining() -> uint32_t {
+    return budget;
+}
+
+} // namespace vial
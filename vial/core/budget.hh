@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vial {
+
+//! Operations a task may complete without suspending before it is made to yield.
+constexpr uint32_t kTaskBudget = 128;
+
+//! Cooperative scheduling budget of the task running on this thread.
+//! The Scheduler refills it each time it resumes a task after a wait or yield (not when a task
+//! hands over to a child it awaits, or back to the parent), and IO awaitables and socket calls
+//! that find their fd (or ring) already ready spend one unit instead of suspending. Once it is spent they yield
+//! back to the scheduler anyway, so a task whose peer is always ready can't hold the worker.
+class CoopBudget {
+  public:
+    //! Spend one unit. Returns false if the budget was already exhausted.
+    static auto consume() -> bool;
+
+    //! Refill the budget (called by the Scheduler before resuming a task).
+    static void reset();
+
+    [[nodiscard]] static auto remaining() -> uint32_t;
+};
+
+} // namespace vial
@@ -0,0 +1,182 @@
+#include "buffer_pool.hh"
+#include <algorithm>
+#include <new>
+#include <numeric>
+#include <sys/mman.h>
+
+namespace vial {
+
+namespace {
+
+constexpr std::align_val_t kBufferAlignment{64};
+
+} // namespace
+
+struct BufferPool::ThreadCache {
+    std::array<std::vector<std::byte*>, kBufferSizeClasses.size()> free;
+
+    ThreadCache() = default;
+    ThreadCache(const ThreadCache&) = delete;
+    ThreadCache(ThreadCache&&) = delete;
+    auto operator=(const ThreadCache&) -> ThreadCache& = delete;
+    auto operator=(ThreadCache&&) -> ThreadCache& = delete;
+
+    //! Hand cached buffers to the depot when the thread exits
+    ~ThreadCache() {
+        auto& pool = BufferPool::instance();
+        for (uint8_t size_class = 0; size_class < free.size(); size_class++) {
+            while (!free.at(size_class).empty()) {
+                pool.spill(size_class, free.at(size_class));
+            }
+        }
+    }
+};
+
+Buffer::Buffer(Buffer&& other) noexcept
+    : data_(other.data_), size_(other.size_), capacity_(other.capacity_), size_class_(other.size_class_),
+      error_(other.error_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
+auto Buffer::operator=(Buffer&& other) noexcept -> Buffer& {
+    if (this != &other) {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        size_class_ = other.size_class_;
+        error_ = other.error_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+    return *this;
+}
+
+Buffer::~Buffer() {
+    release();
+}
+
+void Buffer::release() noexcept {
+    if (data_ != nullptr) {
+        BufferPool::instance().give_back(data_, size_class_);
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+}
+
+BufferPool::BufferPool() {
+    size_t class_bytes = std::accumulate(kBufferSizeClasses.begin(), kBufferSizeClasses.end(), size_t{0});
+    arena_size_ = class_bytes * kArenaBuffersPerClass;
+
+    void* arena = mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (arena == MAP_FAILED) {
+        // Fall back to allocating every buffer on demand
+        arena_size_ = 0;
+        return;
+    }
+    arena_ = static_cast<std::byte*>(arena);
+
+    // Size classes are multiples of the alignment, so every carved buffer stays aligned
+    std::byte* next = arena_;
+    for (uint8_t size_class = 0; size_class < kBufferSizeClasses.size(); size_class++) {
+        auto& depot = depot_.at(size_class);
+        depot.reserve(kArenaBuffersPerClass);
+        for (size_t i = 0; i < kArenaBuffersPerClass; i++) {
+            depot.push_back(next);
+            next += kBufferSizeClasses.at(size_class); // NOLINT
+        }
+    }
+}
+
+BufferPool::~BufferPool() {
+    for (auto& free_list : depot_) {
+        for (auto* data : free_list) {
+            if (!in_arena(data)) { deallocate(data); }
+        }
+    }
+
+    if (arena_ != nullptr) {
+        munmap(arena_, arena_size_);
+    }
+}
+
+auto BufferPool::instance() -> BufferPool& {
+    static BufferPool instance_;
+    return instance_;
+}
+
+auto BufferPool::allocate(size_t capacity) -> std::byte* {
+    return static_cast<std::byte*>(::operator new(capacity, kBufferAlignment));
+}
+
+void BufferPool::deallocate(std::byte* data) noexcept {
+    ::operator delete(data, kBufferAlignment);
+}
+
+auto BufferPool::in_arena(const std::byte* data) const noexcept -> bool {
+    return arena_ != nullptr && data >= arena_ && data < arena_ + arena_size_; // NOLINT
+}
+
+auto BufferPool::local_cache() -> ThreadCache& {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+auto BufferPool::lease(size_t min_capacity) -> Buffer {
+    const auto* it = std::lower_bound(kBufferSizeClasses.begin(), kBufferSizeClasses.end(), min_capacity);
+    if (it == kBufferSizeClasses.end()) {
+        return Buffer{allocate(min_capacity), min_capacity, kUncached};
+    }
+
+    const auto size_class = static_cast<uint8_t>(it - kBufferSizeClasses.begin());
+    auto& free_list = local_cache().free.at(size_class);
+
+    if (free_list.empty()) {
+        refill(size_class, free_list);
+    }
+
+    if (free_list.empty()) {
+        return Buffer{allocate(*it), *it, size_class};
+    }
+
+    std::byte* data = free_list.back();
+    free_list.pop_back();
+    return Buffer{data, *it, size_class};
+}
+
+void BufferPool::give_back(std::byte* data, uint8_t size_class) noexcept {
+    if (size_class == kUncached) {
+        deallocate(data);
+        return;
+    }
+
+    auto& free_list = local_cache().free.at(size_class);
+    if (free_list.size() >= kMaxCachedBuffers) {
+        spill(size_class, free_list);
+    }
+    free_list.push_back(data);
+}
+
+void BufferPool::refill(uint8_t size_class, std::vector<std::byte*>& out) {
+    std::lock_guard guard(depot_lock_);
+    auto& depot = depot_.at(size_class);
+
+    size_t count = std::min(depot.size(), kBufferTransferBatch);
+    out.insert(out.end(), depot.end() - static_cast<ptrdiff_t>(count), depot.end());
+    depot.resize(depot.size() - count);
+}
+
+void BufferPool::spill(uint8_t size_class, std::vector<std::byte*>& in) {
+    std::lock_guard guard(depot_lock_);
+    auto& depot = depot_.at(size_class);
+
+    size_t count = std::min(in.size(), kBufferTransferBatch);
+    depot.insert(depot.end(), in.end() - static_cast<ptrdiff_t>(count), in.end());
+    in.resize(in.size() - count);
+}
+
+} // namespace vial
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace vial {
+
+//! Capacities (bytes) of the buffers handed out by the BufferPool.
+constexpr std::array<size_t, 4> kBufferSizeClasses = {1024, 4096, 16384, 65536};
+
+//! Maximum free buffers of one size class cached by a single thread.
+constexpr size_t kMaxCachedBuffers = 64;
+
+//! Number of buffers moved between a thread cache and the shared depot at once.
+constexpr size_t kBufferTransferBatch = kMaxCachedBuffers / 2;
+
+//! Buffers of each size class carved out of the pre-faulted arena when the pool is created.
+constexpr size_t kArenaBuffersPerClass = 16;
+
+//! A buffer leased from the BufferPool. Returned to the pool when destroyed.
+class Buffer {
+  public:
+    //! Default constructor - empty buffer with no storage
+    Buffer() = default;
+
+    Buffer(Buffer&& other) noexcept;
+    auto operator=(Buffer&& other) noexcept -> Buffer&;
+
+    Buffer(const Buffer&) = delete;
+    auto operator=(const Buffer&) -> Buffer& = delete;
+
+    //! Destructor returns the storage to the pool
+    ~Buffer();
+
+    //! Empty buffer recording why the read that should have filled it failed.
+    [[nodiscard]] static auto failed(int error) noexcept -> Buffer {
+        Buffer buffer;
+        buffer.error_ = error;
+        return buffer;
+    }
+
+    //! Error that ended the read producing this (empty) buffer, 0 on success or EOF.
+    [[nodiscard]] auto error() const noexcept -> int { return error_; }
+
+    //! Pointer to the start of the storage
+    [[nodiscard]] auto data() const noexcept -> std::byte* { return data_; }
+
+    //! Number of valid bytes
+    [[nodiscard]] auto size() const noexcept -> size_t { return size_; }
+
+    //! Size of the underlying storage
+    [[nodiscard]] auto capacity() const noexcept -> size_t { return capacity_; }
+
+    //! Check if the buffer holds no valid bytes
+    [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+    //! Set the number of valid bytes (clamped to capacity)
+    void resize(size_t size) noexcept { size_ = size < capacity_ ? size : capacity_; }
+
+    //! View of the valid bytes
+    [[nodiscard]] auto span() const noexcept -> std::span<std::byte> { return {data_, size_}; }
+
+    //! View of the whole storage, e.g. to read into
+    [[nodiscard]] auto storage() const noexcept -> std::span<std::byte> { return {data_, capacity_}; }
+
+  private:
+    friend class BufferPool;
+
+    Buffer(std::byte* data, size_t capacity, uint8_t size_class)
+        : data_(data), capacity_(capacity), size_class_(size_class) {}
+
+    void release() noexcept;
+
+    std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    uint8_t size_class_ = 0;
+    int error_ = 0;
+};
+
+//! Size-classed pool of IO buffers.
+//! Each thread (i.e. each Scheduler worker) keeps its own free lists, so leasing and
+//! returning a buffer doesn't synchronize. Threads that return more buffers than they
+//! lease spill batches into a shared depot that other threads refill from.
+//! The depot starts out stocked from one contiguous arena whose pages are faulted in up
+//! front, so steady-state IO never takes a page fault or an allocator call on its buffers.
+class BufferPool {
+  public:
+    BufferPool(const BufferPool&) = delete;
+    BufferPool(BufferPool&&) = delete;
+    auto operator=(const BufferPool&) -> BufferPool& = delete;
+    auto operator=(BufferPool&&) -> BufferPool& = delete;
+    ~BufferPool();
+
+    //! Lease a buffer with capacity of at least `min_capacity` bytes.
+    //! Requests larger than the biggest size class get an exact, uncached allocation.
+    [[nodiscard]] auto lease(size_t min_capacity) -> Buffer;
+
+    // Singleton access (for now)
+    static auto instance() -> BufferPool&;
+
+  private:
+    friend class Buffer;
+
+    BufferPool();
+
+    //! Free lists of a single thread
+    struct ThreadCache;
+
+    static constexpr uint8_t kUncached = kBufferSizeClasses.size();
+
+    static auto allocate(size_t capacity) -> std::byte*;
+    static void deallocate(std::byte* data) noexcept;
+
+    //! Check if `data` was carved out of the arena (and so must not be deallocated)
+    [[nodiscard]] auto in_arena(const std::byte* data) const noexcept -> bool;
+
+    void give_back(std::byte* data, uint8_t size_class) noexcept;
+    auto local_cache() -> ThreadCache&;
+
+    //! Move a batch of free buffers from the depot into `out`
+    void refill(uint8_t size_class, std::vector<std::byte*>& out);
+
+    //! Move a batch of free buffers from `in` into the depot
+    void spill(uint8_t size_class, std::vector<std::byte*>& in);
+
+    std::mutex depot_lock_;
+    std::array<std::vector<std::byte*>, kBufferSizeClasses.size()> depot_;
+
+    std::byte* arena_ = nullptr;
+    size_t arena_size_ = 0;
+};
+
+} // namespace vial
@@ -0,0 +1,91 @@
+#include "cancellation.hh"
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vial {
+
+namespace {
+
+const CancellationToken kEmptyToken;
+
+thread_local const CancellationToken* current_token = &kEmptyToken;
+
+} // namespace
+
+struct CancellationToken::State {
+    std::atomic<bool> cancelled = false;
+
+    std::mutex lock;
+    uint64_t next_id = 1;
+    std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+};
+
+auto CancellationToken::create() -> CancellationToken {
+    CancellationToken token;
+    token.state_ = std::make_shared<State>();
+    return token;
+}
+
+void CancellationToken::cancel() const {
+    if (state_ == nullptr) { return; }
+
+    std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+    {
+        std::lock_guard guard(state_->lock);
+        if (state_->cancelled.exchange(true)) { return; }
+        callbacks.swap(state_->callbacks);
+    }
+
+    // Outside the lock, so callbacks may touch the token
+    for (auto& [id, callback] : callbacks) { callback(); }
+}
+
+auto CancellationToken::is_cancelled() const noexcept -> bool {
+    return state_ != nullptr && state_->cancelled.load(std::memory_order_acquire);
+}
+
+auto CancellationToken::on_cancel(std::function<void()> callback) const -> uint64_t {
+    if (state_ == nullptr) { return 0; }
+
+    {
+        std::lock_guard guard(state_->lock);
+        if (!state_->cancelled) {
+            uint64_t id = state_->next_id++;
+            state_->callbacks.emplace_back(id, std::move(callback));
+            return id;
+        }
+    }
+
+    callback();
+    return 0;
+}
+
+void CancellationToken::remove(uint64_t id) const {
+    if (state_ == nullptr || id == 0) { return; }
+
+    std::function<void()> removed;
+    {
+        std::lock_guard guard(state_->lock);
+        auto& callbacks = state_->callbacks;
+        for (auto it = callbacks.begin(); it != callbacks.end(); ++it) {
+            if (it->first == id) {
+                removed = std::move(it->second);
+                *it = std::move(callbacks.back());
+                callbacks.pop_back();
+                break;
+            }
+        }
+    }
+}
+
+auto CancellationToken::current() -> const CancellationToken& {
+    return *current_token;
+}
+
+void CancellationToken::set_current(const CancellationToken* token) {
+    current_token = token != nullptr ? token : &kEmptyToken;
+}
+
+} // namespace vial
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace vial {
+
+//! Cooperative cancellation signal shared by a tree of tasks.
+//! A task created while another task runs inherits that task's token, so cancelling the token
+//! of a request handler reaches everything it spawned or awaits. Tasks parked on IO or a timer
+//! are resumed as soon as the token is cancelled (their wait reports WaitStatus::kCancelled);
+//! running tasks notice at their next wait or by checking `is_cancelled`.
+//! A default constructed token is empty and can never be cancelled.
+class CancellationToken {
+  public:
+    CancellationToken() = default;
+
+    //! Create a new token that can be cancelled.
+    static auto create() -> CancellationToken;
+
+    //! Cancel the token and run every registered callback. Idempotent.
+    void cancel() const;
+
+    //! Check if the token has been cancelled.
+    [[nodiscard]] auto is_cancelled() const noexcept -> bool;
+
+    //! Check if the token can be cancelled (i.e. it isn't empty).
+    explicit operator bool() const noexcept { return state_ != nullptr; }
+
+    //! Run `callback` on cancellation, from the thread calling `cancel`. If the token is
+    //! already cancelled the callback runs right away and 0 is returned.
+    auto on_cancel(std::function<void()> callback) const -> uint64_t;
+
+    //! Drop a callback registered with `on_cancel` (no-op once it has run).
+    void remove(uint64_t id) const;
+
+    //! Token of the task running on this thread (empty outside a task).
+    static auto current() -> const CancellationToken&;
+    static void set_current(const CancellationToken* token);
+
+  private:
+    struct State;
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace vial
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "io/io_awaitables.hh"
+#include "sync.hh"
+
+namespace vial {
+
+//! Size of a cache line, used to keep producer and consumer cursors apart.
+constexpr size_t kCacheLineSize = 64;
+
+//! Slots per segment of an UnboundedRing.
+constexpr size_t kRingSegmentSize = 256;
+
+//! Lock-free bounded MPMC ring (Vyukov). Every slot carries a sequence number telling
+//! producers and consumers whose turn it is, so a push or pop is one CAS on a cursor.
+//! The capacity is rounded up to a power of two (at least 2).
+template <typename T>
+class BoundedRing {
+  public:
+    explicit BoundedRing(size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? 2 : capacity) - 1), cells_(mask_ + 1) {
+        for (size_t i = 0; i <= mask_; i++) { cells_[i].sequence.store(i, std::memory_order_relaxed); }
+    }
+
+    //! Move `value` into the ring unless it is full (in which case `value` is left untouched).
+    auto try_push(T& value) -> bool {
+        size_t position = enqueue_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (diff == 0) {
+                if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value.emplace(std::move(value));
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //! Take the oldest value, if any.
+    auto try_pop() -> std::optional<T> {
+        size_t position = dequeue_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (diff == 0) {
+                if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    std::optional<T> value = std::move(cell.value);
+                    cell.value.reset();
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                position = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] auto capacity() const noexcept -> size_t { return mask_ + 1; }
+
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        std::optional<T> value;
+    };
+
+    const size_t mask_;
+    std::vector<Cell> cells_;
+
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_ = 0;
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_ = 0;
+};
+
+//! Unbounded MPMC queue made of fixed segments whose slots are claimed with a fetch_add (an
+//! FAA array queue). Each slot is written once, so a full segment is sealed for good and
+//! producers move on to a fresh one; drained segments are freed with the last reference to them.
+//! Not lock-free: the segment links are `std::atomic<std::shared_ptr>`, which libstdc++ guards
+//! with a spinlock, so every push and pop takes that lock (and bumps a shared refcount) to load
+//! the head or tail segment. Only the slot claims themselves are lock-free.
+template <typename T>
+class UnboundedRing {
+  public:
+    UnboundedRing() : head_(std::make_shared<Segment>()) { tail_.store(head_.load()); }
+
+    //! Move `value` into the queue. Always succeeds.
+    auto try_push(T& value) -> bool {
+        while (true) {
+            std::shared_ptr<Segment> tail = tail_.load();
+            size_t index = tail->enqueue.fetch_add(1);
+            if (index < kRingSegmentSize) {
+                Cell& cell = tail->cells[index];
+                cell.value.emplace(std::move(value));
+                uint8_t expected = kEmpty;
+                if (cell.state.compare_exchange_strong(expected, kFull)) { return true; }
+
+                // A consumer gave up on this slot before it was filled
+                value = std::move(*cell.value);
+                cell.value.reset();
+                continue;
+            }
+
+            std::shared_ptr<Segment> next = tail->next.load();
+            if (next == nullptr) {
+                auto segment = std::make_shared<Segment>();
+                segment->enqueue.store(1);
+                segment->cells[0].value.emplace(std::move(value));
+                segment->cells[0].state.store(kFull);
+
+                if (tail->next.compare_exchange_strong(next, segment)) {
+                    tail_.compare_exchange_strong(tail, segment);
+                    return true;
+                }
+                value = std::move(*segment->cells[0].value);
+            }
+            tail_.compare_exchange_strong(tail, next);
+        }
+    }
+
+    //! Take the oldest value, if any.
+    auto try_pop() -> std::optional<T> {
+        while (true) {
+            std::shared_ptr<Segment> head = head_.load();
+            if (head->dequeue.load() >= head->enqueue.load() && head->next.load() == nullptr) {
+                return std::nullopt;
+            }
+
+            size_t index = head->dequeue.fetch_add(1);
+            if (index < kRingSegmentSize) {
+                Cell& cell = head->cells[index];
+                if (cell.state.exchange(kTaken) == kFull) {
+                    std::optional<T> value = std::move(cell.value);
+                    cell.value.reset();
+                    return value;
+                }
+                // The producer that claimed this slot hasn't filled it yet and will retry elsewhere
+                continue;
+            }
+
+            std::shared_ptr<Segment> next = head->next.load();
+            if (next == nullptr) { return std::nullopt; }
+            head_.compare_exchange_strong(head, next);
+        }
+    }
+
+  private:
+    static constexpr uint8_t kEmpty = 0;
+    static constexpr uint8_t kFull = 1;
+    static constexpr uint8_t kTaken = 2;
+
+    struct Cell {
+        std::atomic<uint8_t> state = kEmpty;
+        std::optional<T> value;
+    };
+
+    struct Segment {
+        std::array<Cell, kRingSegmentSize> cells;
+        alignas(kCacheLineSize) std::atomic<size_t> enqueue = 0;
+        alignas(kCacheLineSize) std::atomic<size_t> dequeue = 0;
+        std::atomic<std::shared_ptr<Segment>> next;
+    };
+
+    alignas(kCacheLineSize) std::atomic<std::shared_ptr<Segment>> head_;
+    alignas(kCacheLineSize) std::atomic<std::shared_ptr<Segment>> tail_;
+};
+
+//! Async channel between tasks over a `Buffer` (BoundedRing or UnboundedRing).
+//! `co_await send(value)` suspends while the buffer is full and `co_await recv()` while it is
+//! empty; parked tasks are handed values (or free slots) directly by the task on the other end.
+//! Any number of tasks may send and receive concurrently. Once closed, sends fail and receivers
+//! drain what is left before getting std::nullopt. Waits are not cancellable: close the
+//! channel to release them.
+template <typename T, typename Buffer>
+class BasicChannel {
+  public:
+    template <typename... Args>
+    explicit BasicChannel(Args&&... args) : buffer_(std::forward<Args>(args)...) {}
+
+    BasicChannel(const BasicChannel&) = delete;
+    BasicChannel(BasicChannel&&) = delete;
+    auto operator=(const BasicChannel&) -> BasicChannel& = delete;
+    auto operator=(BasicChannel&&) -> BasicChannel& = delete;
+    ~BasicChannel() = default;
+
+    //! Send without suspending. `value` is moved from only on success.
+    auto try_send(T& value) -> bool {
+        if (closed_.load() || !buffer_.try_push(value)) { return false; }
+        pump(true);
+        return true;
+    }
+
+    //! Receive without suspending.
+    auto try_recv() -> std::optional<T> {
+        std::optional<T> value = buffer_.try_pop();
+        if (value) { pump(false); }
+        return value;
+    }
+
+    //! Fail pending and future sends, and wake receivers once the buffer is drained.
+    void close() {
+        closed_.store(true);
+        hand_off_sends();
+        hand_off_recvs();
+    }
+
+    [[nodiscard]] auto is_closed() const noexcept -> bool { return closed_.load(); }
+
+    //! Awaitable yielding true once the value is in the channel, or false if it was closed.
+    struct Send {
+        //! Parked in the channel while the buffer is full
+        struct Node : AsyncWaiter {
+            Send* origin;
+
+            explicit Node(Send* send) : origin(send) {}
+
+            [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Node(origin); }
+
+            void register_with_event_loop(std::function<void()> callback) override {
+                // Another thread may resume the task (and free this node) as soon as it is queued
+                BasicChannel* channel = origin->channel;
+                resume = std::move(callback);
+                channel->senders_.push(this);
+                channel->pump(false);
+            }
+        };
+
+        BasicChannel* channel;
+        T value;
+        bool sent = false;
+
+        [[nodiscard]] auto await_ready() -> bool {
+            if (channel->is_closed()) { return true; }
+            sent = channel->try_send(value);
+            return sent;
+        }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = new Node(this);
+        }
+
+        [[nodiscard]] auto await_resume() const noexcept -> bool { return sent; }
+    };
+
+    //! Awaitable yielding the next value, or std::nullopt once the channel is closed and drained.
+    struct Recv {
+        //! Parked in the channel while the buffer is empty
+        struct Node : AsyncWaiter {
+            Recv* origin;
+
+            explicit Node(Recv* recv) : origin(recv) {}
+
+            [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Node(origin); }
+
+            void register_with_event_loop(std::function<void()> callback) override {
+                BasicChannel* channel = origin->channel;
+                resume = std::move(callback);
+                channel->receivers_.push(this);
+                channel->pump(true);
+            }
+        };
+
+        BasicChannel* channel;
+        std::optional<T> value;
+
+        [[nodiscard]] auto await_ready() -> bool {
+            value = channel->try_recv();
+            // Closing may race with the last send, so look again once closed
+            if (!value && channel->is_closed()) { value = channel->try_recv(); return true; }
+            return value.has_value();
+        }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = new Node(this);
+        }
+
+        auto await_resume() -> std::optional<T> { return std::move(value); }
+    };
+
+    //! e.g. `if (!co_await channel.send(std::move(item))) { /* closed */ }`
+    [[nodiscard]] auto send(T value) -> Send { return Send{this, std::move(value)}; }
+
+    //! e.g. `while (auto item = co_await channel.recv()) { ... }`
+    [[nodiscard]] auto recv() -> Recv { return Recv{this, std::nullopt}; }
+
+  private:
+    //! Move values of parked senders into the buffer. Returns true if any sender was resumed.
+    auto hand_off_sends() -> bool {
+        if (senders_.waiting() == 0) { return false; }
+        return senders_.drain([this](AsyncWaiter& waiter) {
+            Send& send = *static_cast<typename Send::Node&>(waiter).origin;
+            if (closed_.load()) { return true; }
+            send.sent = buffer_.try_push(send.value);
+            return send.sent;
+        }) > 0;
+    }
+
+    //! Pass buffered values to parked receivers. Returns true if any receiver was resumed.
+    auto hand_off_recvs() -> bool {
+        if (receivers_.waiting() == 0) { return false; }
+        return receivers_.drain([this](AsyncWaiter& waiter) {
+            Recv& recv = *static_cast<typename Recv::Node&>(waiter).origin;
+            recv.value = buffer_.try_pop();
+            return recv.value.has_value() || closed_.load();
+        }) > 0;
+    }
+
+    //! Resume parked tasks after a push (`pushed`) or a pop, alternating sides while hand-offs
+    //! keep freeing slots or adding values.
+    void pump(bool pushed) {
+        // Pairs with the waiter count bump when parking: one side always sees the other
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (pushed ? hand_off_recvs() : hand_off_sends()) { pushed = !pushed; }
+    }
+
+    Buffer buffer_;
+    std::atomic<bool> closed_ = false;
+
+    AsyncWaitQueue senders_;
+    AsyncWaitQueue receivers_;
+};
+
+//! Bounded channel: `Channel<T> channel{capacity};`
+template <typename T>
+using Channel = BasicChannel<T, BoundedRing<T>>;
+
+//! Unbounded channel, whose sends never suspend: `UnboundedChannel<T> channel;`
+template <typename T>
+using UnboundedChannel = BasicChannel<T, UnboundedRing<T>>;
+
+} // namespace vial
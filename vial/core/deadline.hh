@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "io/io_awaitables.hh"
+#include "timer_wheel.hh"
+
+namespace vial {
+
+//! Outcome of a wait raced against a deadline, shared by the waiter and both callbacks.
+struct DeadlineState {
+    //! Set by whichever of the wait or the timer finishes first
+    std::atomic<bool> fired = false;
+    bool timed_out = false;
+};
+
+//! Registration of an awaitable raced against a timer on the current worker's wheel.
+//! Whichever fires first withdraws the other before resuming the task, so a timed out wait
+//! doesn't leave a stale callback behind (e.g. an fd waiter in the IOEventLoop).
+struct DeadlineWait : IOAwaitable {
+    std::unique_ptr<IOAwaitable> inner;
+    TimerClock::time_point deadline;
+    std::shared_ptr<DeadlineState> state;
+    TimerEntry entry;
+
+    DeadlineWait(IOAwaitable* awaitable, TimerClock::time_point time_point, std::shared_ptr<DeadlineState> shared)
+        : inner(awaitable), deadline(time_point), state(std::move(shared)) {}
+
+    [[nodiscard]] auto clone() const -> IOAwaitable* override {
+        return new DeadlineWait(inner->clone(), deadline, state);
+    }
+
+    void register_with_event_loop(std::function<void()> callback) override {
+        auto resume = std::make_shared<std::function<void()>>(std::move(callback));
+
+        // Set up the timer first: the inner registration may complete immediately
+        if (TimerWheel* wheel = TimerWheel::current(); wheel != nullptr) {
+            wheel->schedule(entry, deadline, [this, state = state, resume]() {
+                if (state->fired.exchange(true)) { return; }
+                inner->cancel();
+                state->timed_out = true;
+                (*resume)();
+            });
+        }
+
+        // Only touches `this` after winning, since the task (and so this awaitable) may be gone otherwise
+        inner->register_with_event_loop([this, state = state, resume]() {
+            if (state->fired.exchange(true)) { return; }
+            entry.cancel();
+            (*resume)();
+        });
+    }
+
+    auto cancel() -> bool override {
+        // Already dispatched: its callback (or the timer's) resumes the task
+        if (!inner->cancel()) { return false; }
+        if (state->fired.exchange(true)) { return false; }
+        entry.cancel();
+        return true;
+    }
+};
+
+//! Awaitable that waits for `Awaitable` until an optional deadline.
+//! `co_await` yields kTimedOut if the deadline passed first, or kCancelled if the task's
+//! cancellation token fired. Without a deadline it parks on `Awaitable` directly.
+//! `Awaitable` is one of the IO awaitables, which flag `out_of_budget` when they must yield.
+template <typename Awaitable>
+struct WithDeadline {
+    Awaitable inner;
+    std::optional<TimerClock::time_point> deadline;
+    std::shared_ptr<DeadlineState> state;
+
+    //! Cancellation token of the suspending task
+    const CancellationToken* token = nullptr;
+
+    template <typename... Args>
+    explicit WithDeadline(std::optional<TimerClock::time_point> time_point, Args&&... args)
+        : inner(std::forward<Args>(args)...), deadline(time_point) {}
+
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+        if (inner.await_ready()) { return true; }
+        if (deadline && TimerClock::now() >= *deadline) {
+            state = std::make_shared<DeadlineState>();
+            state->timed_out = true;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename S>
+    auto await_suspend(std::coroutine_handle<S> handle) noexcept -> bool {
+        token = &handle.promise().get_cancellation_token();
+        if (token->is_cancelled()) { return false; }
+
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        if (inner.out_of_budget) {
+            // Ready, but the task has used up its budget: yield, no deadline to race
+            handle.promise().get_io_awaitable() = new ResumeNow;
+            return true;
+        }
+        if (!deadline) {
+            handle.promise().get_io_awaitable() = inner.clone();
+            return true;
+        }
+
+        state = std::make_shared<DeadlineState>();
+        handle.promise().get_io_awaitable() = new DeadlineWait(inner.clone(), *deadline, state);
+        return true;
+    }
+
+    auto await_resume() const noexcept -> WaitStatus {
+        if (state != nullptr && state->timed_out) { return WaitStatus::kTimedOut; }
+        if (token != nullptr && token->is_cancelled()) { return WaitStatus::kCancelled; }
+        return WaitStatus::kReady;
+    }
+};
+
+//! Wait for an `Awaitable` constructed from `args`, giving up at `deadline` if one is set.
+//! e.g. `if (co_await with_deadline<WaitForRead>(deadline, fd) != WaitStatus::kReady) { ... }`
+template <typename Awaitable, typename... Args>
+auto with_deadline(std::optional<TimerClock::time_point> deadline, Args&&... args) -> WithDeadline<Awaitable> {
+    return WithDeadline<Awaitable>{deadline, std::forward<Args>(args)...};
+}
+
+} // namespace vial
@@ -2,11 +2,20 @@
 
 #include <coroutine>
 #include "io_event_loop.hh"
+#include "../budget.hh"
 #include "../task.hh"
 #include <poll.h>
+#include <optional>
 
 namespace vial {
 
+//! Outcome of waiting on an awaitable that can give up.
+enum class WaitStatus : std::uint8_t {
+    kReady,
+    kTimedOut,
+    kCancelled
+};
+
 class IOAwaitable {
   public:
     IOAwaitable() = default;
@@ -20,15 +29,55 @@ class IOAwaitable {
     [[nodiscard]] virtual auto clone() const -> IOAwaitable* = 0;
 
     virtual void register_with_event_loop(std::function<void()> callback) = 0;
+
+    //! Withdraw the callback passed to `register_with_event_loop` if it hasn't been dispatched yet.
+    //! Returns true if it was withdrawn (and so will never run).
+    virtual auto cancel() -> bool { return false; }
+};
+
+//! Parked instead of the real wait by an awaitable that was ready but out of budget (and by
+//! `yield`): resumes the task straight away, behind the tasks already queued.
+struct ResumeNow : IOAwaitable {
+    [[nodiscard]] auto clone() const -> IOAwaitable* override { return new ResumeNow; }
+
+    void register_with_event_loop(std::function<void()> callback) override { callback(); }
 };
 
+//! Charge a ready awaitable to the task's CoopBudget. Returns whether it may complete without
+//! suspending; `out_of_budget` is set when it must yield instead of waiting.
+inline auto spend_budget(bool ready, bool& out_of_budget) -> bool {
+    out_of_budget = ready && !CoopBudget::consume();
+    return ready && !out_of_budget;
+}
+
 //! Awaitable that suspends until file descriptor is ready for reading
 struct WaitForRead : IOAwaitable {
     int fd;
     
+    //! Readiness sequence snapshot taken before the caller's failed attempt, if it tried first
+    std::optional<uint32_t> since;
+
+    //! Cancellation token of the suspending task
+    const CancellationToken* token = nullptr;
+
+    //! Set by `await_ready` when the fd was ready but the task has to yield first
+    bool out_of_budget = false;
+    
     explicit WaitForRead(int file_descriptor) : fd(file_descriptor) {}
     
-    [[nodiscard]] auto await_ready()  noexcept -> bool {
+    //! Wait for a read event newer than `sequence` (see IOEventLoop::read_sequence), skipping the poll
+    WaitForRead(int file_descriptor, uint32_t sequence) : fd(file_descriptor), since(sequence) {}
+    
+    //! Ready (and within the task's budget), so the wait can be skipped
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+        return spend_budget(poll_ready(), out_of_budget);
+    }
+
+    [[nodiscard]] auto poll_ready() const noexcept -> bool {
+        if (since) {
+            return IOEventLoop::instance().read_sequence(fd) != *since;
+        }
+        
         // if there is data to read, don't suspend
         struct pollfd pfd = {fd, POLLIN, 0};
         int ret = poll(&pfd, 1, 0);
@@ -39,20 +88,38 @@ struct WaitForRead : IOAwaitable {
         return ret > 0;
     }
     
+    //! Doesn't suspend if the task's cancellation token has already fired.
     template <typename S>
-    void await_suspend(std::coroutine_handle<S> handle) noexcept { 
+    auto await_suspend(std::coroutine_handle<S> handle) noexcept -> bool {
+        token = &handle.promise().get_cancellation_token();
+        if (token->is_cancelled()) { return false; }
+
         handle.promise().set_state(TaskState::kBlockedOnIO);
-        handle.promise().get_io_awaitable() = this->clone();
+        handle.promise().get_io_awaitable() = out_of_budget ? new ResumeNow : this->clone();
+        return true;
     }
 
-    void await_resume() noexcept {}
+    //! kCancelled if the wait was cut short by the task's cancellation token
+    auto await_resume() const noexcept -> WaitStatus {
+        return token != nullptr && token->is_cancelled() ? WaitStatus::kCancelled : WaitStatus::kReady;
+    }
 
     [[nodiscard]] auto clone() const -> IOAwaitable* override {
-        return new WaitForRead(fd);
+        auto* copy = new WaitForRead(fd);
+        copy->since = since;
+        return copy;
     }
 
     void register_with_event_loop(std::function<void()> callback) override {
-        IOEventLoop::instance().register_read_callback(fd, callback);
+        if (since) {
+            IOEventLoop::instance().register_read_callback(fd, callback, *since);
+        } else {
+            IOEventLoop::instance().register_read_callback(fd, callback);
+        }
+    }
+
+    auto cancel() -> bool override {
+        return IOEventLoop::instance().cancel_read_callback(fd);
     }
 };
 
@@ -60,9 +127,30 @@ struct WaitForRead : IOAwaitable {
 struct WaitForWrite : IOAwaitable {
     int fd;
     
+    //! Readiness sequence snapshot taken before the caller's failed attempt, if it tried first
+    std::optional<uint32_t> since;
+
+    //! Cancellation token of the suspending task
+    const CancellationToken* token = nullptr;
+
+    //! Set by `await_ready` when the fd was ready but the task has to yield first
+    bool out_of_budget = false;
+    
     explicit WaitForWrite(int file_descriptor) : fd(file_descriptor) {}
     
-    [[nodiscard]] auto await_ready()  noexcept -> bool {
+    //! Wait for a write event newer than `sequence` (see IOEventLoop::write_sequence), skipping the poll
+    WaitForWrite(int file_descriptor, uint32_t sequence) : fd(file_descriptor), since(sequence) {}
+    
+    //! Ready (and within the task's budget), so the wait can be skipped
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+        return spend_budget(poll_ready(), out_of_budget);
+    }
+
+    [[nodiscard]] auto poll_ready() const noexcept -> bool {
+        if (since) {
+            return IOEventLoop::instance().write_sequence(fd) != *since;
+        }
+        
         // if there is space to write, don't suspend
         struct pollfd pfd = {fd, POLLOUT, 0};
         int ret = poll(&pfd, 1, 0);
@@ -73,21 +161,82 @@ struct WaitForWrite : IOAwaitable {
         return ret > 0;
     }
     
+    //! Doesn't suspend if the task's cancellation token has already fired.
+    template <typename S>
+    auto await_suspend(std::coroutine_handle<S> handle) noexcept -> bool {
+        token = &handle.promise().get_cancellation_token();
+        if (token->is_cancelled()) { return false; }
+
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = out_of_budget ? new ResumeNow : this->clone();
+        return true;
+    }
+
+    //! kCancelled if the wait was cut short by the task's cancellation token
+    auto await_resume() const noexcept -> WaitStatus {
+        return token != nullptr && token->is_cancelled() ? WaitStatus::kCancelled : WaitStatus::kReady;
+    }
+
+    [[nodiscard]] auto clone() const -> IOAwaitable* override {
+        auto* copy = new WaitForWrite(fd);
+        copy->since = since;
+        return copy;
+    }
+
+    void register_with_event_loop(std::function<void()> callback) override {
+        if (since) {
+            IOEventLoop::instance().register_write_callback(fd, callback, *since);
+        } else {
+            IOEventLoop::instance().register_write_callback(fd, callback);
+        }
+    }
+
+    auto cancel() -> bool override {
+        return IOEventLoop::instance().cancel_write_callback(fd);
+    }
+};
+
+//! Awaitable that suspends until file descriptor has a pending error (e.g. error queue notifications)
+struct WaitForError : IOAwaitable {
+    int fd;
+    
+    //! Set by `await_ready` when the fd was ready but the task has to yield first
+    bool out_of_budget = false;
+
+    explicit WaitForError(int file_descriptor) : fd(file_descriptor) {}
+    
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+        return spend_budget(poll_ready(), out_of_budget);
+    }
+
+    [[nodiscard]] auto poll_ready() const noexcept -> bool {
+        // POLLERR is always reported, no need to request it
+        struct pollfd pfd = {fd, 0, 0};
+        int ret = poll(&pfd, 1, 0);
+        if (ret == -1) {
+            std::cerr << "[WaitForError] poll failed" << std::endl;
+            return false;
+        }
+        return (pfd.revents & POLLERR) != 0;
+    }
+    
     template <typename S>
     void await_suspend(std::coroutine_handle<S> handle) noexcept {
         handle.promise().set_state(TaskState::kBlockedOnIO);
-        handle.promise().get_io_awaitable() = this->clone();
+        handle.promise().get_io_awaitable() = out_of_budget ? new ResumeNow : this->clone();
     }
     
     void await_resume() noexcept {}
 
     [[nodiscard]] auto clone() const -> IOAwaitable* override {
-        return new WaitForWrite(fd);
+        return new WaitForError(fd);
     }
 
     void register_with_event_loop(std::function<void()> callback) override {
-        IOEventLoop::instance().register_write_callback(fd, callback);
+        IOEventLoop::instance().register_error_callback(fd, callback);
     }
+
+    // Not cancellable: the error queue carries completions the caller must not abandon (e.g. MSG_ZEROCOPY)
 };
 
 } // namespace vial
\ No newline at end of file
@@ -21,6 +21,10 @@ IOEventLoop::~IOEventLoop() {
         close(epoll_fd_);
         std::cout << "[IOEventLoop] Closed epoll fd" << std::endl;
     }
+
+    for (auto& chunk : slot_chunks_) {
+        delete[] chunk.load(); // NOLINT
+    }
 }
 
 auto IOEventLoop::instance() -> IOEventLoop& {
@@ -28,8 +32,34 @@ auto IOEventLoop::instance() -> IOEventLoop& {
     return instance_;
 }
 
+auto IOEventLoop::find_slot(int fd) const -> FdSlot* {
+    auto index = static_cast<size_t>(fd);
+    if (fd < 0 || index / kFdSlotChunkSize >= kMaxFdSlotChunks) { return nullptr; }
+
+    FdSlot* chunk = slot_chunks_.at(index / kFdSlotChunkSize).load(std::memory_order_acquire);
+    return chunk == nullptr ? nullptr : &chunk[index % kFdSlotChunkSize]; // NOLINT
+}
+
+auto IOEventLoop::slot(int fd) -> FdSlot* {
+    auto index = static_cast<size_t>(fd);
+    if (fd < 0 || index / kFdSlotChunkSize >= kMaxFdSlotChunks) {
+        std::cout << "[IOEventLoop] fd " << fd << " is outside the slot table" << std::endl;
+        return nullptr;
+    }
+
+    auto& chunk = slot_chunks_.at(index / kFdSlotChunkSize);
+    if (chunk.load(std::memory_order_relaxed) == nullptr) {
+        chunk.store(new FdSlot[kFdSlotChunkSize], std::memory_order_release); // NOLINT
+    }
+    return &chunk.load(std::memory_order_relaxed)[index % kFdSlotChunkSize]; // NOLINT
+}
+
 void IOEventLoop::register_fd(int fd) {
-    if (registered_fds_.contains(fd)) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = slot(fd);
+    if (fd_slot == nullptr) { return; }
+
+    if (fd_slot->registered) {
         std::cout << "[IOEventLoop] fd " << fd << " already registered" << std::endl;
         return;
     }
@@ -44,37 +74,175 @@ void IOEventLoop::register_fd(int fd) {
         return;
     }
     
-    registered_fds_.insert(fd);
+    fd_slot->registered = true;
 }
 
 void IOEventLoop::unregister_fd(int fd) {
-    if (!registered_fds_.contains(fd)) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = find_slot(fd);
+    if (fd_slot == nullptr || !fd_slot->registered) {
         std::cout << "[IOEventLoop] fd " << fd << " not registered" << std::endl;
         return;
     }
     
     epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
-    registered_fds_.erase(fd);
+    fd_slot->registered = false;
+    
+    // Not dispatched again once this returns; a dispatch already running finishes on its copy
+    fd_slot->multishot_read_callback = nullptr;
+}
+
+auto IOEventLoop::read_sequence(int fd) const -> uint32_t {
+    const FdSlot* fd_slot = find_slot(fd);
+    return fd_slot == nullptr ? 0 : fd_slot->read_events.load();
+}
+
+auto IOEventLoop::write_sequence(int fd) const -> uint32_t {
+    const FdSlot* fd_slot = find_slot(fd);
+    return fd_slot == nullptr ? 0 : fd_slot->write_events.load();
 }
 
 void IOEventLoop::register_read_callback(int fd, std::function<void()> callback) {
-    if (read_callbacks_.contains(fd)) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = slot(fd);
+    if (fd_slot == nullptr) { return; }
+
+    if (fd_slot->read_callback) {
         // TODO: Do this better, queue read waiters somehow maybe?
         std::cout << "[IOEventLoop] WARNING - fd " << fd << " already has a read waiter!" << std::endl;
         return;
     }
     
-    read_callbacks_[fd] = std::move(callback);
+    fd_slot->read_callback = std::move(callback);
 }
 
 void IOEventLoop::register_write_callback(int fd, std::function<void()> callback) {
-    if (write_callbacks_.contains(fd)) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = slot(fd);
+    if (fd_slot == nullptr) { return; }
+
+    if (fd_slot->write_callback) {
         // TODO: Do this better, queue write waiters somehow maybe?
         std::cout << "[IOEventLoop] WARNING - fd " << fd << " already has a write waiter!" << std::endl;
         return;
     }
     
-    write_callbacks_[fd] = std::move(callback);
+    fd_slot->write_callback = std::move(callback);
+}
+
+void IOEventLoop::register_read_callback(int fd, std::function<void()> callback, uint32_t since) {
+    {
+        std::lock_guard guard(lock_);
+        FdSlot* fd_slot = slot(fd);
+        if (fd_slot != nullptr && fd_slot->read_events.load() == since) {
+            if (fd_slot->read_callback) {
+                std::cout << "[IOEventLoop] WARNING - fd " << fd << " already has a read waiter!" << std::endl;
+                return;
+            }
+
+            fd_slot->read_callback = std::move(callback);
+            return;
+        }
+    }
+
+    // Became readable after the caller's attempt
+    callback();
+}
+
+void IOEventLoop::register_write_callback(int fd, std::function<void()> callback, uint32_t since) {
+    {
+        std::lock_guard guard(lock_);
+        FdSlot* fd_slot = slot(fd);
+        if (fd_slot != nullptr && fd_slot->write_events.load() == since) {
+            if (fd_slot->write_callback) {
+                std::cout << "[IOEventLoop] WARNING - fd " << fd << " already has a write waiter!" << std::endl;
+                return;
+            }
+
+            fd_slot->write_callback = std::move(callback);
+            return;
+        }
+    }
+
+    // Became writable after the caller's attempt
+    callback();
+}
+
+void IOEventLoop::register_error_callback(int fd, std::function<void()> callback) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = slot(fd);
+    if (fd_slot == nullptr) { return; }
+
+    if (fd_slot->error_callback) {
+        std::cout << "[IOEventLoop] WARNING - fd " << fd << " already has an error waiter!" << std::endl;
+        return;
+    }
+    
+    fd_slot->error_callback = std::move(callback);
+}
+
+void IOEventLoop::register_multishot_read_callback(int fd, std::function<void()> callback) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = slot(fd);
+    if (fd_slot == nullptr) { return; }
+
+    if (fd_slot->multishot_read_callback) {
+        std::cout << "[IOEventLoop] WARNING - fd " << fd << " already has a multishot read callback!" << std::endl;
+        return;
+    }
+    
+    fd_slot->multishot_read_callback = std::move(callback);
+}
+
+void IOEventLoop::pause_reads(int fd) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = find_slot(fd);
+    if (fd_slot == nullptr || !fd_slot->registered) { return; }
+
+    // Level-triggered EPOLLIN would report the unread data on every epoll_wait
+    epoll_event ev{};
+    ev.events = EPOLLOUT;
+    ev.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void IOEventLoop::resume_reads(int fd) {
+    std::lock_guard guard(lock_);
+    FdSlot* fd_slot = find_slot(fd);
+    if (fd_slot == nullptr || !fd_slot->registered) { return; }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+auto IOEventLoop::take_callback(std::function<void()>& callback) -> std::function<void()> {
+    std::lock_guard guard(lock_);
+    return std::exchange(callback, nullptr);
+}
+
+auto IOEventLoop::cancel_callback(int fd, std::function<void()> FdSlot::*callback) -> bool {
+    std::function<void()> removed;
+    {
+        std::lock_guard guard(lock_);
+        FdSlot* fd_slot = find_slot(fd);
+        if (fd_slot == nullptr) { return false; }
+        removed = std::exchange(fd_slot->*callback, nullptr);
+    }
+    return static_cast<bool>(removed);
+}
+
+auto IOEventLoop::cancel_read_callback(int fd) -> bool {
+    return cancel_callback(fd, &FdSlot::read_callback);
+}
+
+auto IOEventLoop::cancel_write_callback(int fd) -> bool {
+    return cancel_callback(fd, &FdSlot::write_callback);
+}
+
+auto IOEventLoop::cancel_error_callback(int fd) -> bool {
+    return cancel_callback(fd, &FdSlot::error_callback);
 }
 
 void IOEventLoop::run() {
@@ -100,23 +268,40 @@ void IOEventLoop::run() {
         for (int i = 0; i < num_events; i++) {
             int fd = events.at(i).data.fd;
             uint32_t event_flags = events.at(i).events;
+
+            FdSlot* fd_slot = find_slot(fd);
+            if (fd_slot == nullptr) { continue; }
              
             // Handle read events
             if ((event_flags & EPOLLIN) != 0) {
-                if (auto it = read_callbacks_.find(fd); it != read_callbacks_.end()) {
-                    // execute callback
-                    auto callback = it->second;
-                    read_callbacks_.erase(it);
+                // Bump before dispatching so a concurrent `since` registration either sees it or is dispatched
+                fd_slot->read_events.fetch_add(1);
+
+                // Stays armed: run a copy, outside the lock so other fds can register meanwhile
+                std::function<void()> multishot;
+                {
+                    std::lock_guard guard(lock_);
+                    multishot = fd_slot->multishot_read_callback;
+                }
+                if (multishot) { multishot(); }
+
+                if (auto callback = take_callback(fd_slot->read_callback)) {
                     callback();
                 }
             }
             
             // Handle write events
             if ((event_flags & EPOLLOUT) != 0) {
-                if (auto it = write_callbacks_.find(fd); it != write_callbacks_.end()) { 
-                    // execute callback
-                    auto callback = it->second;
-                    write_callbacks_.erase(it);
+                fd_slot->write_events.fetch_add(1);
+
+                if (auto callback = take_callback(fd_slot->write_callback)) {
+                    callback();
+                }
+            }
+
+            // Handle error queue events (EPOLLERR is always reported, e.g. MSG_ZEROCOPY completions)
+            if ((event_flags & EPOLLERR) != 0) {
+                if (auto callback = take_callback(fd_slot->error_callback)) {
                     callback();
                 }
             }
@@ -131,4 +316,4 @@ void IOEventLoop::stop() {
     running_ = false;
 }
 
-} // namespace vial
\ No newline at end of file
+} // namespace vial
@@ -1,37 +1,102 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <coroutine>
+#include <cstdint>
 #include <functional>
-#include <unordered_set>
-#include <unordered_map>
+#include <mutex>
 #include <sys/epoll.h>
 
 namespace vial {
 
+//! Number of fd slots allocated at once by the IOEventLoop.
+constexpr size_t kFdSlotChunkSize = 1024;
+
+//! Maximum number of slot chunks (registered fds must be below kFdSlotChunkSize * kMaxFdSlotChunks).
+constexpr size_t kMaxFdSlotChunks = 1024;
+
+//! Per-fd state of a registered fd, kept in a table indexed directly by fd.
+struct FdSlot {
+    bool registered = false;
+
+    //! Bumped by the loop on every read/write readiness event for the fd.
+    std::atomic<uint32_t> read_events = 0;
+    std::atomic<uint32_t> write_events = 0;
+
+    std::function<void()> read_callback;
+    std::function<void()> write_callback;
+    std::function<void()> error_callback;
+    std::function<void()> multishot_read_callback;
+};
+
 //! IOEventLoop manages IO events and resumes waiting coroutines when IO is ready.
 class IOEventLoop { // NOLINT
   public:
     IOEventLoop();
     ~IOEventLoop();
-    
+
     void register_fd(int fd);
     void unregister_fd(int fd);
     void register_read_callback(int fd, std::function<void()> callback);
     void register_write_callback(int fd, std::function<void()> callback);
+    void register_error_callback(int fd, std::function<void()> callback);
+
+    //! Readiness sequence of a registered fd. Snapshot it before attempting a non-blocking
+    //! syscall, and pass it to the `since` overloads below if the syscall would block.
+    [[nodiscard]] auto read_sequence(int fd) const -> uint32_t;
+    [[nodiscard]] auto write_sequence(int fd) const -> uint32_t;
+
+    //! Register a read/write callback, or run it immediately if a readiness event arrived
+    //! after the `since` snapshot (so an event between the attempt and the registration isn't lost).
+    void register_read_callback(int fd, std::function<void()> callback, uint32_t since);
+    void register_write_callback(int fd, std::function<void()> callback, uint32_t since);
+
+    //! Register a callback that stays armed and runs on every read event until `unregister_fd`.
+    //! Runs on the event loop thread, unlocked, on a copy of `callback`: a dispatch that started
+    //! before `unregister_fd` may still be running after it returns, so the callback must own
+    //! what it touches and stop using the fd once its owner closes it.
+    void register_multishot_read_callback(int fd, std::function<void()> callback);
+
+    //! Stop read events for `fd` (e.g. while the consumer of a multishot callback is full), and
+    //! restart them.
+    void pause_reads(int fd);
+    void resume_reads(int fd);
+
+    //! Remove a pending read/write/error callback without running it.
+    //! Returns false if there was none (e.g. it has already been dispatched).
+    auto cancel_read_callback(int fd) -> bool;
+    auto cancel_write_callback(int fd) -> bool;
+    auto cancel_error_callback(int fd) -> bool;
+
     void run();
     void stop();
-    
+
     // Singleton access (for now)
     static auto instance() -> IOEventLoop&;
-    
+
   private:
-    std::unordered_set<int> registered_fds_;
-    
-    std::unordered_map<int, std::function<void()>> read_callbacks_;
-    std::unordered_map<int, std::function<void()>> write_callbacks_;
-    
+    //! Slot for `fd`, or nullptr if none was ever allocated for it.
+    [[nodiscard]] auto find_slot(int fd) const -> FdSlot*;
+
+    //! Slot for `fd`, allocating its chunk if needed. Requires `lock_`.
+    auto slot(int fd) -> FdSlot*;
+
+    //! Remove and return a one-shot callback.
+    auto take_callback(std::function<void()>& callback) -> std::function<void()>;
+
+    //! Remove a one-shot callback of `fd`, if set.
+    auto cancel_callback(int fd, std::function<void()> FdSlot::*callback) -> bool;
+
+    // Fd-indexed slot table, allocated in chunks. Chunks are never freed while the loop lives,
+    // so worker threads can read readiness sequences without taking the lock.
+    std::array<std::atomic<FdSlot*>, kMaxFdSlotChunks> slot_chunks_{};
+
+    // Guards slot registration and callbacks, which worker threads modify while `run` dispatches
+    std::mutex lock_;
+
     int epoll_fd_ = -1;
     bool running_ = false;
 };
 
-} // namespace vial
\ No newline at end of file
+} // namespace vial
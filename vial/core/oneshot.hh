@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "io/io_awaitables.hh"
+
+namespace vial {
+
+//! Hand-off slot shared by a OneshotSender and its OneshotReceiver (one allocation per pair).
+template <typename T>
+struct OneshotState {
+    static constexpr uint8_t kEmpty = 0;
+    static constexpr uint8_t kWaiting = 1;
+    static constexpr uint8_t kSent = 2;
+    static constexpr uint8_t kClosed = 3;
+
+    std::atomic<uint8_t> state = kEmpty;
+    std::optional<T> value;
+
+    //! Parked receiver, published by the kEmpty -> kWaiting transition
+    std::function<void()> resume;
+
+    //! Move to `final` (kSent or kClosed), resuming a parked receiver.
+    void complete(uint8_t final) {
+        if (state.exchange(final) == kWaiting) { std::exchange(resume, nullptr)(); }
+    }
+};
+
+//! Sending half of a oneshot channel. Sends at most one value; dropping it unsent wakes the
+//! receiver with std::nullopt.
+template <typename T>
+class OneshotSender {
+  public:
+    explicit OneshotSender(std::shared_ptr<OneshotState<T>> state) : state_(std::move(state)) {}
+
+    OneshotSender(OneshotSender&&) noexcept = default;
+    auto operator=(OneshotSender&& other) noexcept -> OneshotSender& {
+        if (this != &other) {
+            close();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+
+    OneshotSender(const OneshotSender&) = delete;
+    auto operator=(const OneshotSender&) -> OneshotSender& = delete;
+
+    ~OneshotSender() { close(); }
+
+    //! Deliver `value` to the receiver. Later calls are ignored.
+    void send(T value) {
+        if (state_ == nullptr) { return; }
+        state_->value.emplace(std::move(value));
+        std::exchange(state_, nullptr)->complete(OneshotState<T>::kSent);
+    }
+
+  private:
+    void close() {
+        if (state_ != nullptr) { std::exchange(state_, nullptr)->complete(OneshotState<T>::kClosed); }
+    }
+
+    std::shared_ptr<OneshotState<T>> state_;
+};
+
+//! Receiving half of a oneshot channel: `co_await receiver` yields the value, or std::nullopt
+//! if the sender was dropped without sending.
+template <typename T>
+class OneshotReceiver {
+  public:
+    explicit OneshotReceiver(std::shared_ptr<OneshotState<T>> state) : state_(std::move(state)) {}
+
+    //! Check if the value (or the sender's drop) has arrived.
+    [[nodiscard]] auto is_ready() const noexcept -> bool {
+        return state_->state.load() >= OneshotState<T>::kSent;
+    }
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return is_ready(); }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) noexcept {
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = new Wait(state_);
+    }
+
+    auto await_resume() -> std::optional<T> {
+        if (state_->state.load() != OneshotState<T>::kSent) { return std::nullopt; }
+        return std::move(state_->value);
+    }
+
+  private:
+    //! Parked while the value is pending
+    struct Wait : IOAwaitable {
+        std::shared_ptr<OneshotState<T>> state;
+
+        explicit Wait(std::shared_ptr<OneshotState<T>> shared) : state(std::move(shared)) {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Wait(state); }
+
+        void register_with_event_loop(std::function<void()> callback) override {
+            state->resume = std::move(callback);
+            uint8_t expected = OneshotState<T>::kEmpty;
+            if (!state->state.compare_exchange_strong(expected, OneshotState<T>::kWaiting)) {
+                // Sent (or dropped) while the task was suspending
+                std::exchange(state->resume, nullptr)();
+            }
+        }
+    };
+
+    std::shared_ptr<OneshotState<T>> state_;
+};
+
+//! Create a single-value channel, e.g. to correlate a request with its response:
+//! `auto [sender, receiver] = oneshot<Response>(); ...; auto response = co_await receiver;`
+template <typename T>
+auto oneshot() -> std::pair<OneshotSender<T>, OneshotReceiver<T>> {
+    auto state = std::make_shared<OneshotState<T>>();
+    return {OneshotSender<T>{state}, OneshotReceiver<T>{state}};
+}
+
+} // namespace vial
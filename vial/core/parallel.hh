@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "scheduler.hh"
+#include "task.hh"
+
+namespace vial {
+
+//! Run time a parallel loop aims for between two checks for idle workers.
+constexpr auto kParallelChunkTime = std::chrono::microseconds(50);
+
+//! Shared state of one parallel loop over [first, last).
+//! Each task walks its range in chunks whose size adapts towards kParallelChunkTime. Between
+//! chunks it hands the upper half of what is left to a new task, but only while workers are
+//! idle, so a loop on a busy scheduler runs as a handful of tasks instead of one per grain.
+//! Results are combined left to right, so `combine` only needs to be associative.
+template <typename Index, typename T, typename Chunk, typename Combine>
+class ParallelLoop {
+  public:
+    ParallelLoop(Scheduler& scheduler, T identity, Chunk chunk, Combine combine)
+        : scheduler_(scheduler), identity_(std::move(identity)), chunk_(std::move(chunk)), combine_(std::move(combine)) {}
+
+    //! Fold [begin, end), splitting on demand. `split` is set for tasks split off another.
+    auto run(Index begin, Index end, bool split) -> Task<T> {
+        if (split) { unclaimed_.fetch_sub(1); }
+
+        T accumulator = identity_;
+        std::vector<Task<T>> children;
+        Index grain = 1;
+
+        try {
+            while (begin < end && !failed_.load(std::memory_order_relaxed)) {
+                Index stop = begin + std::min<Index>(grain, end - begin);
+                auto start = std::chrono::steady_clock::now();
+                accumulator = chunk_(begin, stop, std::move(accumulator));
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                begin = stop;
+
+                if (elapsed < kParallelChunkTime / 2) {
+                    grain = grain * 2;
+                } else if (elapsed > kParallelChunkTime * 2 && grain > 1) {
+                    grain = grain / 2;
+                }
+
+                // Workers already woken by an earlier split don't count as demand
+                if (end - begin >= 2 * grain && scheduler_.idle_workers() > unclaimed_.load()) {
+                    Index middle = begin + (end - begin) / 2;
+                    unclaimed_.fetch_add(1);
+                    children.push_back(scheduler_.spawn_task(run(middle, end, true)));
+                    end = middle;
+                }
+            }
+        } catch (...) {
+            fail(std::current_exception());
+        }
+
+        // Children cover consecutive ranges to the right of ours, the latest split first
+        for (auto child = children.rbegin(); child != children.rend(); ++child) {
+            T part = co_await *child;
+            accumulator = combine_(std::move(accumulator), std::move(part));
+        }
+        co_return accumulator;
+    }
+
+    //! Rethrow the first exception that escaped the body.
+    void rethrow() {
+        std::lock_guard guard(lock_);
+        if (error_) { std::rethrow_exception(error_); }
+    }
+
+  private:
+    void fail(std::exception_ptr exception) {
+        std::lock_guard guard(lock_);
+        if (!error_) { error_ = std::move(exception); }
+        failed_.store(true);
+    }
+
+    Scheduler& scheduler_;
+    T identity_;
+    Chunk chunk_;
+    Combine combine_;
+
+    // Split tasks that haven't started yet
+    std::atomic<size_t> unclaimed_ = 0;
+
+    std::atomic<bool> failed_ = false;
+    std::mutex lock_;
+    std::exception_ptr error_;
+};
+
+//! Call `body(i)` for every i in [first, last), in parallel across the scheduler's workers.
+//! e.g. `co_await parallel_for(scheduler, size_t{0}, v.size(), [&](size_t i) { v[i] *= 2; });`
+//! The first exception thrown by `body` stops the loop and is rethrown.
+template <typename Index, typename Body>
+auto parallel_for(Scheduler& scheduler, Index first, Index last, Body body) -> Task<void> {
+    auto chunk = [&body](Index begin, Index end, std::monostate none) {
+        for (Index i = begin; i < end; i++) { body(i); }
+        return none;
+    };
+    auto combine = [](std::monostate none, std::monostate /*unused*/) { return none; };
+
+    ParallelLoop<Index, std::monostate, decltype(chunk), decltype(combine)> loop{scheduler, {}, chunk, combine};
+    co_await loop.run(first, last, false);
+    loop.rethrow();
+}
+
+//! Fold [first, last) in parallel: each task computes `accumulator = body(accumulator, i)`
+//! starting from `identity`, and partial results are merged with `combine`, which must be
+//! associative (and `identity` neutral for it).
+//! e.g. `co_await parallel_reduce(scheduler, size_t{0}, v.size(), 0L,
+//!          [&](long sum, size_t i) { return sum + v[i]; }, std::plus<>{});`
+template <typename Index, typename T, typename Body, typename Combine>
+auto parallel_reduce(Scheduler& scheduler, Index first, Index last, T identity, Body body, Combine combine) -> Task<T> {
+    auto chunk = [&body](Index begin, Index end, T accumulator) {
+        for (Index i = begin; i < end; i++) { accumulator = body(std::move(accumulator), i); }
+        return accumulator;
+    };
+
+    ParallelLoop<Index, T, decltype(chunk), Combine> loop{scheduler, std::move(identity), chunk, std::move(combine)};
+    T result = co_await loop.run(first, last, false);
+    loop.rethrow();
+    co_return result;
+}
+
+} // namespace vial
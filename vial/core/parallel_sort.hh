@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "scheduler.hh"
+#include "task.hh"
+#include "when.hh"
+
+namespace vial {
+
+//! Ranges up to this size are sorted with std::sort on one worker.
+constexpr std::ptrdiff_t kParallelSortCutoff = std::ptrdiff_t{1} << 14;
+
+//! Merges up to this size run sequentially.
+constexpr std::ptrdiff_t kParallelMergeCutoff = std::ptrdiff_t{1} << 15;
+
+//! Merge sorted [first1, last1) and [first2, last2) into `out` (moving the elements), splitting
+//! the larger run at its middle and the other at the matching bound so both halves merge in
+//! parallel.
+template <typename In, typename Out, typename Compare>
+auto parallel_merge(Scheduler& scheduler, In first1, In last1, In first2, In last2, Out out, Compare comp) -> Task<void> {
+    auto size1 = std::distance(first1, last1);
+    auto size2 = std::distance(first2, last2);
+
+    if (size1 + size2 <= kParallelMergeCutoff) {
+        std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+                   std::make_move_iterator(first2), std::make_move_iterator(last2), out, comp);
+        co_return;
+    }
+
+    if (size1 < size2) {
+        std::swap(first1, first2);
+        std::swap(last1, last2);
+        std::swap(size1, size2);
+    }
+
+    In middle1 = first1 + size1 / 2;
+    In middle2 = std::lower_bound(first2, last2, *middle1, comp);
+    Out middle_out = out + (middle1 - first1) + (middle2 - first2);
+
+    co_await when_all(scheduler,
+                      parallel_merge(scheduler, first1, middle1, first2, middle2, out, comp),
+                      parallel_merge(scheduler, middle1, last1, middle2, last2, middle_out, comp));
+}
+
+//! Sort [first, last) using `scratch` (as long as the range) as the other half of a ping-pong
+//! buffer: the sorted run ends up in `scratch` if `to_scratch` is set, in place otherwise, so
+//! no level of the recursion copies back or allocates.
+template <typename Data, typename Scratch, typename Compare>
+auto parallel_sort_into(Scheduler& scheduler, Data first, Data last, Scratch scratch, bool to_scratch, Compare comp)
+    -> Task<void> {
+    auto size = std::distance(first, last);
+
+    if (size <= kParallelSortCutoff) {
+        std::sort(first, last, comp);
+        if (to_scratch) { std::move(first, last, scratch); }
+        co_return;
+    }
+
+    // Sort both halves into the opposite buffer, then merge them into the target
+    auto half = size / 2;
+    co_await when_all(scheduler,
+                      parallel_sort_into(scheduler, first, first + half, scratch, !to_scratch, comp),
+                      parallel_sort_into(scheduler, first + half, last, scratch + half, !to_scratch, comp));
+
+    if (to_scratch) {
+        co_await parallel_merge(scheduler, first, first + half, first + half, last, scratch, comp);
+    } else {
+        co_await parallel_merge(scheduler, scratch, scratch + half, scratch + half, scratch + size, first, comp);
+    }
+}
+
+//! Sort [first, last) with `comp` across the scheduler's workers (not stable).
+//! A parallel merge sort with parallel merges, using one scratch buffer of the range's size.
+//! e.g. `co_await parallel_sort(scheduler, v.begin(), v.end());`
+template <typename Iterator, typename Compare = std::less<>>
+auto parallel_sort(Scheduler& scheduler, Iterator first, Iterator last, Compare comp = {}) -> Task<void> {
+    auto size = std::distance(first, last);
+    if (size <= kParallelSortCutoff) {
+        std::sort(first, last, comp);
+        co_return;
+    }
+
+    std::vector<typename std::iterator_traits<Iterator>::value_type> scratch(size);
+    co_await parallel_sort_into(scheduler, first, last, scratch.begin(), false, comp);
+}
+
+} // namespace vial
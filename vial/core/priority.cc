@@ -0,0 +1,19 @@
+#include "priority.hh"
+
+namespace vial {
+
+namespace {
+
+thread_local TaskPriority current = TaskPriority::kNormal;
+
+} // namespace
+
+auto current_priority() -> TaskPriority {
+    return current;
+}
+
+void set_current_priority(TaskPriority priority) {
+    current = priority;
+}
+
+} // namespace vial
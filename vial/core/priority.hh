@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vial {
+
+//! Scheduling class of a task. Workers run the highest non-empty level first, so a burst of
+//! background work doesn't queue in front of latency-critical request handlers.
+//! A task created while another task runs inherits that task's priority.
+enum class TaskPriority : std::uint8_t {
+  kLatency,
+  kNormal,
+  kBackground
+};
+
+constexpr size_t kNumTaskPriorities = 3;
+
+//! Priority of the task running on this thread (kNormal outside a task).
+auto current_priority() -> TaskPriority;
+void set_current_priority(TaskPriority priority);
+
+} // namespace vial
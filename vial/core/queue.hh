@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <queue>
 #include <mutex>
 #include <optional>
+#include <utility>
 
 namespace vial {
 
@@ -36,4 +39,60 @@ class Queue {
     std::queue<T> contents_;
 };
 
+//! Lock-free multi-producer single-consumer inbox.
+//! Producers push from any thread with a single CAS; the owner takes everything pushed so far
+//! with a single exchange and sees it in push order. Intrusive: items are linked through their
+//! own `T* inbox_next` member, so pushing never allocates. The inbox doesn't own its items, and
+//! an item must not be pushed again before it has been drained.
+template <typename T>
+class Inbox {
+  public:
+    Inbox() = default;
+
+    Inbox(const Inbox&) = delete;
+    Inbox(Inbox&&) = delete;
+    auto operator=(const Inbox&) -> Inbox& = delete;
+    auto operator=(Inbox&&) -> Inbox& = delete;
+    ~Inbox() = default;
+
+    void push (T* item) {
+      item->inbox_next = head_.load(std::memory_order_relaxed);
+      while (!head_.compare_exchange_weak(item->inbox_next, item, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    //! Check for pushed items without taking them (consumer only).
+    [[nodiscard]] auto empty () const noexcept -> bool {
+      return head_.load(std::memory_order_relaxed) == nullptr;
+    }
+
+    //! Call `fn(item)` for every item pushed so far, oldest first. Returns the number taken.
+    template <typename F>
+    auto drain (F&& fn) -> size_t {
+      T* item = head_.exchange(nullptr, std::memory_order_acquire);
+
+      // Pushes stack up newest first
+      T* oldest = nullptr;
+      while (item != nullptr) {
+        T* next = item->inbox_next;
+        item->inbox_next = oldest;
+        oldest = item;
+        item = next;
+      }
+
+      size_t count = 0;
+      while (oldest != nullptr) {
+        // `fn` may push the item again
+        T* next = std::exchange(oldest->inbox_next, nullptr);
+        fn(oldest);
+        oldest = next;
+        count++;
+      }
+      return count;
+    }
+
+  private:
+    // On its own cache line, producers hammer it
+    alignas(64) std::atomic<T*> head_ = nullptr;
+};
+
 };
\ No newline at end of file
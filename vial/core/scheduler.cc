@@ -1,26 +1,232 @@
 #include "scheduler.hh"
+#include "budget.hh"
 #include "task.hh"
 #include "io/io_awaitables.hh"
+#include <algorithm>
 #include <thread>
 #include <cassert>
 #include <set>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 namespace vial {
 
-Scheduler::Scheduler(unsigned int num_workers) : num_workers_(num_workers) {
-    queues_ = std::vector<std::queue<TaskBase*>>(num_workers_);
+namespace {
+
+//! Park on `io_awaitable` until it completes or `token` is cancelled, whichever comes first.
+//! Cancellation withdraws the registration before resuming, so nothing is left in the event loop.
+//! `token` is a copy since the task (and its promise) may be gone as soon as it is resumed.
+void register_cancellable(IOAwaitable* io_awaitable, CancellationToken token, std::function<void()> resume) {
+    struct Race {
+        std::mutex lock;
+        bool finished = false;
+        uint64_t cancel_id = 0;
+    };
+    auto race = std::make_shared<Race>();
+    auto shared_resume = std::make_shared<std::function<void()>>(std::move(resume));
+
+    io_awaitable->register_with_event_loop([race, token, shared_resume]() {
+        uint64_t cancel_id = 0;
+        {
+            std::lock_guard guard(race->lock);
+            if (race->finished) { return; }
+            race->finished = true;
+            cancel_id = race->cancel_id;
+        }
+        token.remove(cancel_id);
+        (*shared_resume)();
+    });
+
+    // Runs immediately if the token was cancelled before (or during) the registration above.
+    // Only touches the awaitable while the race is open, since the task owns and frees it once resumed.
+    uint64_t cancel_id = token.on_cancel([race, io_awaitable, shared_resume]() {
+        {
+            std::lock_guard guard(race->lock);
+            if (race->finished || !io_awaitable->cancel()) { return; }
+            race->finished = true;
+        }
+        (*shared_resume)();
+    });
+
+    std::lock_guard guard(race->lock);
+    if (race->finished) {
+        token.remove(cancel_id);
+    } else {
+        race->cancel_id = cancel_id;
+    }
+}
+
+// Worker running on this thread, set for the lifetime of `run_worker`
+thread_local const Scheduler* current_scheduler = nullptr;
+thread_local size_t current_worker_index = 0;
+
+} // namespace
+
+Scheduler::Scheduler(unsigned int num_workers)
+    : queues_(num_workers), timers_(num_workers), num_workers_(num_workers) {
+    lifo_slots_ = std::vector<LifoSlot>(num_workers_);
+    inboxes_.reserve(num_workers_);
+    for (size_t i = 0; i < num_workers_; i++) {
+        inboxes_.push_back(std::make_unique<Inbox<TaskBase>>());
+    }
 }
 
 auto Scheduler::push_task(TaskBase* task, size_t worker_id) -> void {
     task->set_enqueued_true();
-    if (queues_[worker_id].size() > kMaxLocalTasks) {
-        queues_[worker_id].push(task);
+
+    // The newest task takes the slot, the one it displaces queues as usual
+    task = std::exchange(lifo_slots_[worker_id].task, task);
+    if (task == nullptr) { return; }
+
+    auto& local = queues_[worker_id];
+    std::lock_guard guard(local.lock);
+    push_local(local, task);
+}
+
+void Scheduler::push_local(LocalQueues& local, TaskBase* task) {
+    auto& level = local.levels[static_cast<size_t>(task->get_priority())];
+    if (level.size() < kMaxLocalTasks) {
+        level.push(task);
+        local.size.fetch_add(1, std::memory_order_relaxed);
     } else {
-        global_queue_.push(task);
+        push_global(task);
     }
 }
 
+void Scheduler::schedule(TaskBase* task) {
+    if (auto worker = current_worker()) {
+        push_task(task, *worker);
+        return;
+    }
+    push_global(task);
+}
+
+void Scheduler::push_global(TaskBase* task) {
+    task->set_enqueued_true();
+    global_queues_[static_cast<size_t>(task->get_priority())].push(task);
+}
+
+void Scheduler::wake(TaskBase* task, size_t worker_id) {
+    if (auto worker = current_worker()) {
+        push_task(task, *worker);
+        return;
+    }
+    task->set_enqueued_true();
+    if (idle_workers() > 0 && !queues_[worker_id].idle.load(std::memory_order_relaxed)) {
+        push_global(task);
+        return;
+    }
+    inboxes_[worker_id]->push(task);
+}
+
+auto Scheduler::current_worker() const -> std::optional<size_t> {
+    if (current_scheduler != this) { return std::nullopt; }
+    return current_worker_index;
+}
+
+auto Scheduler::current_worker_id() -> std::optional<size_t> {
+    if (current_scheduler == nullptr) { return std::nullopt; }
+    return current_worker_index;
+}
+
+auto Scheduler::next_task(size_t worker_id, uint64_t pick) -> std::optional<TaskBase*> {
+    auto& local = queues_[worker_id];
+    auto& slot = lifo_slots_[worker_id];
+    std::unique_lock guard(local.lock);
+
+    if (auto& inbox = *inboxes_[worker_id]; !inbox.empty()) {
+        inbox.drain([&](TaskBase* task) { push_local(local, task); });
+    }
+
+    const bool global_first = pick % kGlobalPollInterval == 0;
+
+    auto take_queued = [&](size_t level) -> std::optional<TaskBase*> {
+        auto& local_queue = local.levels[level];
+        if (!local_queue.empty()) {
+            TaskBase* task = local_queue.front();
+            local_queue.pop();
+            local.size.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+        return global_queues_[level].try_get();
+    };
+
+    auto take = [&](size_t level) -> std::optional<TaskBase*> {
+        if (global_first) {
+            if (auto task = global_queues_[level].try_get()) {
+                slot.runs = 0;
+                return task;
+            }
+        }
+
+        if (slot.task != nullptr && static_cast<size_t>(slot.task->get_priority()) == level) {
+            TaskBase* task = std::exchange(slot.task, nullptr);
+            if (slot.runs < kMaxLifoRuns) {
+                slot.runs++;
+                return task;
+            }
+            // Served from the slot too often in a row: wait behind the queued tasks
+            local.levels[level].push(task);
+            local.size.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto task = take_queued(level);
+        if (task) { slot.runs = 0; }
+        return task;
+    };
+
+    size_t first = static_cast<size_t>(TaskPriority::kLatency);
+    if (pick % kBackgroundPickInterval == 0) {
+        first = static_cast<size_t>(TaskPriority::kBackground);
+    } else if (pick % kNormalPickInterval == 0) {
+        first = static_cast<size_t>(TaskPriority::kNormal);
+    }
+
+    if (auto task = take(first)) { return task; }
+    for (size_t level = 0; level < kNumTaskPriorities; level++) {
+        if (level == first) { continue; }
+        if (auto task = take(level)) { return task; }
+    }
+
+    guard.unlock();
+    return steal(worker_id);
+}
+
+auto Scheduler::steal(size_t worker_id) -> std::optional<TaskBase*> {
+    for (size_t offset = 1; offset < num_workers_; offset++) {
+        auto& victim = queues_[(worker_id + offset) % num_workers_];
+        if (victim.size.load(std::memory_order_relaxed) == 0) { continue; }
+
+        std::array<TaskBase*, kMaxStealBatch> stolen{};
+        size_t count = 0;
+        {
+            std::lock_guard guard(victim.lock);
+            for (auto& level : victim.levels) {
+                if (level.empty()) { continue; }
+                count = std::min((level.size() + 1) / 2, kMaxStealBatch);
+                for (size_t i = 0; i < count; i++) {
+                    stolen[i] = level.front();
+                    level.pop();
+                }
+                victim.size.fetch_sub(count, std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (count == 0) { continue; }
+
+        // Never holds two workers' locks at once, so thieves can't deadlock on each other
+        if (count > 1) {
+            auto& local = queues_[worker_id];
+            std::lock_guard guard(local.lock);
+            for (size_t i = 1; i < count; i++) { push_local(local, stolen[i]); }
+        }
+        return stolen[0];
+    }
+    return std::nullopt;
+}
+
 auto Scheduler::start () -> void {
     running_ = true;
     std::vector<std::thread> workers;
@@ -41,15 +247,33 @@ auto Scheduler::stop () -> void {
 }
 
 void Scheduler::run_worker(size_t worker_id) {
-    auto& local_queue = queues_[worker_id];
+    auto& timers = timers_[worker_id];
+    TimerWheel::set_current(&timers);
+    current_scheduler = this;
+    current_worker_index = worker_id;
+
+    // Counts from 1 so the first pick serves the highest level
+    uint64_t picks = 1;
+
     while (running_) {
-        std::optional<TaskBase*> task_opt = local_queue.empty() ? std::nullopt : std::optional(local_queue.front());
-        
-        if(task_opt != std::nullopt) { local_queue.pop(); }
+        timers.advance(TimerClock::now());
+
+        std::optional<TaskBase*> task_opt = next_task(worker_id, picks);
 
-        while (task_opt == std::nullopt && running_) { task_opt = global_queue_.try_get(); }
+        if (task_opt == std::nullopt) {
+            // Idle workers are demand for parallel loops to split their ranges
+            idle_workers_.fetch_add(1, std::memory_order_relaxed);
+            queues_[worker_id].idle.store(true, std::memory_order_relaxed);
+            while (task_opt == std::nullopt && running_) {
+                task_opt = next_task(worker_id, picks);
+                if (task_opt == std::nullopt) { timers.advance(TimerClock::now()); }
+            }
+            queues_[worker_id].idle.store(false, std::memory_order_relaxed);
+            idle_workers_.fetch_sub(1, std::memory_order_relaxed);
+        }
 
         if (task_opt == std::nullopt) { continue; }
+        picks++;
 
         TaskBase* task = task_opt.value();
         TaskState state = task->get_state();
@@ -60,7 +284,17 @@ void Scheduler::run_worker(size_t worker_id) {
             task->clear_awaiting();
             task->clear_io_awaitable();
 
+            // Tasks created while this one runs inherit its cancellation token and priority
+            CancellationToken::set_current(&task->get_cancellation_token());
+            set_current_priority(task->get_priority());
+            // A child starting or a parent resuming after its child completed is one step of the
+            // same chain, so it runs on the budget the chain has left
+            const bool chained = io_awaitable_to_delete == nullptr &&
+                                 (task_to_delete != nullptr || task->get_callback() != nullptr);
+            if (!chained) { CoopBudget::reset(); }
             state = task->run();
+            CancellationToken::set_current(nullptr);
+            set_current_priority(TaskPriority::kNormal);
 
             if (task_to_delete != nullptr) {
                 task_to_delete->destroy();
@@ -84,13 +318,33 @@ void Scheduler::run_worker(size_t worker_id) {
             case kBlockedOnIO: {
                 // if blocked on IO, register callback with event loop
                 auto *io_awaitable = task->get_io_awaitable();
-                io_awaitable->register_with_event_loop([task, this, worker_id]() {
+                // A yield goes behind the work queued anywhere, not just on this worker
+                const bool yielding = dynamic_cast<ResumeNow*>(io_awaitable) != nullptr;
+
+                // Otherwise runs on whichever thread completes the wait: a worker handing the task
+                // something runs it itself, other threads send it back to this worker
+                auto resume = [task, this, worker_id, yielding]() {
                     task->set_state(kAwaiting);
-                    push_task(task->clone(), worker_id);
-                });
+                    if (yielding) {
+                        push_global(task->clone());
+                    } else {
+                        wake(task->clone(), worker_id);
+                    }
+                };
+
+                if (const auto& token = task->get_cancellation_token(); token) {
+                    register_cancellable(io_awaitable, CancellationToken{token}, std::move(resume));
+                } else {
+                    io_awaitable->register_with_event_loop(std::move(resume));
+                }
             } break;
 
             case kComplete: {
+                if (auto* hook = task->get_completion_hook(); hook != nullptr) {
+                    task->set_completion_hook(nullptr);
+                    hook->on_complete(*task);
+                }
+
                 if (task->get_callback() != nullptr) {
                     push_task(task->get_callback(), worker_id);
                     // delete task;
@@ -104,6 +358,9 @@ void Scheduler::run_worker(size_t worker_id) {
             } break;
         }
     }
+
+    TimerWheel::set_current(nullptr);
+    current_scheduler = nullptr;
 }
 
 };
\ No newline at end of file
@@ -1,15 +1,41 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <thread>
 
+#include "priority.hh"
 #include "task.hh"
 #include "queue.hh"
+#include "timer_wheel.hh"
 
 namespace vial {
 
 constexpr size_t kMaxLocalTasks = 256;
 
+//! Most tasks an idle worker takes from another worker's local queue at once (it takes half the
+//! queue, up to this), so a fan-out queued on one busy worker spreads over the idle ones.
+constexpr size_t kMaxStealBatch = kMaxLocalTasks / 2;
+
+//! Starvation protection: every kNormalPickInterval-th task a worker picks is taken from the
+//! normal level first, and every kBackgroundPickInterval-th from the background level, so a
+//! steady stream of higher priority work slows the lower levels down but never stalls them.
+constexpr uint64_t kNormalPickInterval = 8;
+constexpr uint64_t kBackgroundPickInterval = 32;
+
+//! Every kGlobalPollInterval-th pick a worker checks the global queue before its local one, so
+//! tasks spawned from outside the workers still run while workers keep feeding themselves.
+constexpr uint64_t kGlobalPollInterval = 61;
+
+//! Tasks a worker runs in a row from its LIFO slot before the slot's task has to queue behind
+//! the others, so two tasks handing work back and forth can't monopolize the worker.
+constexpr uint32_t kMaxLifoRuns = 3;
+
 class Scheduler {
   public:
     Scheduler(unsigned int num_workers = std::thread::hardware_concurrency());
@@ -17,8 +43,23 @@ class Scheduler {
     auto start () -> void;
     auto stop () -> void;
 
+    //! Queue a ready task in `worker_id`'s LIFO slot, so it runs next while its data is still
+    //! in cache. The task it displaces goes to the local queue, or to the global queue if the
+    //! local one is full, where idle workers can steal it. Must be called from that worker.
     auto push_task(TaskBase* task, size_t worker_id) -> void;
 
+    //! Queue a ready task near the caller: on the calling worker's queues when called from one
+    //! of this scheduler's workers, on the global queue otherwise. Workers that run out of work
+    //! steal from the other workers' local queues, but not from their LIFO slots: a task left in
+    //! the slot waits for its worker's current task to finish.
+    void schedule(TaskBase* task);
+
+    //! Index of the worker running on this thread, if it is one of this scheduler's.
+    [[nodiscard]] auto current_worker() const -> std::optional<size_t>;
+
+    //! Index of the worker running on this thread, in whichever scheduler it belongs to.
+    static auto current_worker_id() -> std::optional<size_t>;
+
     //! Spawn a task that starts executing immediately
     //! The task will be deleted on completion.
     template <typename T>
@@ -27,22 +68,95 @@ class Scheduler {
       spawn_task(task);
     }
 
-    //! Spawn a task that starts executing immediately.
+    //! fire_and_forget at `priority`.
+    template <typename T>
+    void fire_and_forget(Task<T> task, TaskPriority priority) {
+      task.set_priority(priority);
+      fire_and_forget(task);
+    }
+
+    //! Spawn a task that starts executing immediately (on the spawning worker, if any).
     //! You should `co_await` the`Task<T>` at some point before it goes out of scope.
     //! If you do not need to `co_await` it, use `fire_and_forget` instead.
     template <typename T>
     auto spawn_task(Task<T> task) -> Task<T> {
       task.set_enqueued_true();
-      global_queue_.push(task.clone());
+      schedule(task.clone());
       return task;
     }
 
+    //! spawn_task at `priority` (by default a task runs at the priority of its creator).
+    //! e.g. `scheduler.spawn_task(handle_request(conn), TaskPriority::kLatency);`
+    template <typename T>
+    auto spawn_task(Task<T> task, TaskPriority priority) -> Task<T> {
+      task.set_priority(priority);
+      return spawn_task(task);
+    }
+
+    //! Number of workers currently looking for a task.
+    [[nodiscard]] auto idle_workers() const noexcept -> size_t {
+      return idle_workers_.load(std::memory_order_relaxed);
+    }
+
   private:
     void run_worker (size_t worker_id);
 
-    std::vector<std::queue<TaskBase*>> queues_;
-    Queue<TaskBase*> global_queue_;
+    //! Queue a ready task on the global queue of its priority.
+    void push_global (TaskBase* task);
+
+    //! Queue a task whose wait completed. Called from a worker (a mutex release, a channel send,
+    //! a timer), the task goes to that worker's LIFO slot, next to the data it was handed. From
+    //! any other thread (IO thread, blocking pool) it goes through the inbox of `worker_id`, the
+    //! worker it suspended on, or to the global queue if that worker is busy while others are
+    //! idle, so it doesn't wait behind a long running task.
+    void wake (TaskBase* task, size_t worker_id);
+
+    //! Take the next task for `worker_id`, highest priority first. `pick` counts the
+    //! worker's picks and decides when the lower levels go first.
+    auto next_task (size_t worker_id, uint64_t pick) -> std::optional<TaskBase*>;
+
+    //! Take the oldest tasks of another worker's highest non-empty level: run one, keep the rest.
+    auto steal (size_t worker_id) -> std::optional<TaskBase*>;
+
+    //! A worker's queued tasks, one queue per priority level. Idle workers steal from them, so
+    //! every access holds `lock`; `size` lets thieves skip empty queues without taking it.
+    struct alignas(64) LocalQueues {
+        std::mutex lock;
+        std::array<std::queue<TaskBase*>, kNumTaskPriorities> levels;
+        std::atomic<size_t> size = 0;
+
+        // Set while the worker is looking for a task
+        std::atomic<bool> idle = false;
+    };
+
+    //! Queue `task` on its level of `local`, or on the global queue once that level is full.
+    //! `local.lock` must be held.
+    void push_local (LocalQueues& local, TaskBase* task);
+
+    // One queue per priority level
+    using GlobalQueues = std::array<Queue<TaskBase*>, kNumTaskPriorities>;
+
+    std::vector<LocalQueues> queues_;
+
+    //! Most recently readied task of a worker, run before its queues (one cache line each)
+    struct alignas(64) LifoSlot {
+        TaskBase* task = nullptr;
+
+        // Consecutive picks served from the slot
+        uint32_t runs = 0;
+    };
+
+    std::vector<LifoSlot> lifo_slots_;
+
+    // Wakeups from other threads (IO thread, blocking pool, other workers), drained by the owner
+    std::vector<std::unique_ptr<Inbox<TaskBase>>> inboxes_;
+
+    // One timer wheel per worker, advanced by that worker's run loop
+    std::vector<TimerWheel> timers_;
+    GlobalQueues global_queues_;
     
+    std::atomic<size_t> idle_workers_ = 0;
+
     bool running_ = false;
     size_t num_workers_;
 };
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <iostream>
+
+#include "io/io_awaitables.hh"
+#include "timer_wheel.hh"
+
+namespace vial {
+
+//! Awaitable that suspends until a deadline has passed, without blocking the worker.
+//! The timer lives on the wheel of the worker that suspended the task.
+struct WaitUntil : IOAwaitable {
+    TimerClock::time_point deadline;
+    TimerEntry entry;
+
+    //! Cancellation token of the suspending task
+    const CancellationToken* token = nullptr;
+
+    explicit WaitUntil(TimerClock::time_point time_point) : deadline(time_point) {}
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool {
+        return TimerClock::now() >= deadline;
+    }
+
+    //! Doesn't suspend if the task's cancellation token has already fired.
+    template <typename S>
+    auto await_suspend(std::coroutine_handle<S> handle) noexcept -> bool {
+        token = &handle.promise().get_cancellation_token();
+        if (token->is_cancelled()) { return false; }
+
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = this->clone();
+        return true;
+    }
+
+    //! kCancelled if the sleep was cut short by the task's cancellation token
+    auto await_resume() const noexcept -> WaitStatus {
+        return token != nullptr && token->is_cancelled() ? WaitStatus::kCancelled : WaitStatus::kReady;
+    }
+
+    [[nodiscard]] auto clone() const -> IOAwaitable* override {
+        return new WaitUntil(deadline);
+    }
+
+    void register_with_event_loop(std::function<void()> callback) override {
+        TimerWheel* wheel = TimerWheel::current();
+        if (wheel == nullptr) {
+            std::cerr << "[WaitUntil] no timer wheel on this thread, not sleeping" << std::endl;
+            callback();
+            return;
+        }
+        wheel->schedule(entry, deadline, std::move(callback));
+    }
+
+    auto cancel() -> bool override {
+        return entry.cancel();
+    }
+};
+
+//! Suspend the current task until `deadline`.
+inline auto sleep_until(TimerClock::time_point deadline) -> WaitUntil {
+    return WaitUntil{deadline};
+}
+
+//! Suspend the current task for at least `duration` (rounded up to kTimerTick).
+template <typename Rep, typename Period>
+auto sleep_for(std::chrono::duration<Rep, Period> duration) -> WaitUntil {
+    return WaitUntil{TimerClock::now() + std::chrono::duration_cast<TimerClock::duration>(duration)};
+}
+
+} // namespace vial
@@ -0,0 +1,134 @@
+#include "sync.hh"
+#include <utility>
+
+namespace vial {
+
+void AsyncWaitQueue::push(AsyncWaiter* waiter) {
+    std::lock_guard guard(lock_);
+    waiter->next = nullptr;
+    if (tail_ == nullptr) {
+        head_ = waiter;
+    } else {
+        tail_->next = waiter;
+    }
+    tail_ = waiter;
+    waiting_.fetch_add(1);
+}
+
+auto AsyncWaitQueue::pop() -> AsyncWaiter* {
+    AsyncWaiter* waiter = head_;
+    unlink(nullptr, waiter);
+    return waiter;
+}
+
+void AsyncWaitQueue::unlink(AsyncWaiter* previous, AsyncWaiter* waiter) {
+    if (previous == nullptr) {
+        head_ = waiter->next;
+    } else {
+        previous->next = waiter->next;
+    }
+    if (tail_ == waiter) { tail_ = previous; }
+    waiter->next = nullptr;
+    waiting_.fetch_sub(1);
+}
+
+auto AsyncWaitQueue::take(size_t count) -> AsyncWaiter* {
+    AsyncWaiter* taken = nullptr;
+    AsyncWaiter** tail = &taken;
+
+    std::lock_guard guard(lock_);
+    for (; head_ != nullptr && count > 0; count--) {
+        *tail = pop();
+        tail = &(*tail)->next;
+    }
+    return taken;
+}
+
+void AsyncWaitQueue::resume_all(AsyncWaiter* chain) {
+    while (chain != nullptr) {
+        // The task frees its waiter once resumed
+        AsyncWaiter* next = std::exchange(chain->next, nullptr);
+        auto resume = std::move(chain->resume);
+        resume();
+        chain = next;
+    }
+}
+
+auto AsyncLockGuard::operator=(AsyncLockGuard&& other) noexcept -> AsyncLockGuard& {
+    if (this != &other) {
+        unlock();
+        mutex_ = std::exchange(other.mutex_, nullptr);
+    }
+    return *this;
+}
+
+void AsyncLockGuard::unlock() {
+    if (mutex_ != nullptr) { std::exchange(mutex_, nullptr)->unlock(); }
+}
+
+void AsyncMutex::unlock() {
+    locked_.store(false);
+    if (waiters_.waiting() > 0) {
+        waiters_.drain([this](AsyncWaiter& /*waiter*/) { return try_lock(); });
+    }
+}
+
+void AsyncMutex::Lock::register_with_event_loop(std::function<void()> callback) {
+    // Another thread may resume the task (and free this waiter) as soon as it is queued
+    AsyncMutex* owner = mutex;
+    resume = std::move(callback);
+    owner->waiters_.push(this);
+
+    // The holder may have unlocked before seeing this waiter
+    owner->waiters_.drain([owner](AsyncWaiter& /*waiter*/) { return owner->try_lock(); });
+}
+
+auto AsyncSemaphore::try_acquire() noexcept -> bool {
+    size_t permits = permits_.load();
+    while (permits > 0) {
+        if (permits_.compare_exchange_weak(permits, permits - 1)) { return true; }
+    }
+    return false;
+}
+
+void AsyncSemaphore::release(size_t count) {
+    permits_.fetch_add(count);
+    if (waiters_.waiting() > 0) {
+        waiters_.drain([this](AsyncWaiter& /*waiter*/) { return try_acquire(); });
+    }
+}
+
+void AsyncSemaphore::Acquire::register_with_event_loop(std::function<void()> callback) {
+    AsyncSemaphore* owner = semaphore;
+    resume = std::move(callback);
+    owner->waiters_.push(this);
+
+    // Permits may have been released before this waiter was visible
+    owner->waiters_.drain([owner](AsyncWaiter& /*waiter*/) { return owner->try_acquire(); });
+}
+
+void AsyncCondVar::Wait::register_with_event_loop(std::function<void()> callback) {
+    AsyncMutex* held = mutex;
+    resume = std::move(callback);
+
+    // Queue before unlocking, so a notifier that takes the mutex next sees this waiter
+    condvar->waiters_.push(this);
+    held->unlock();
+}
+
+void AsyncCondVar::notify(size_t count) {
+    if (waiters_.waiting() == 0) { return; }
+
+    AsyncWaiter* chain = waiters_.take(count);
+    while (chain != nullptr) {
+        auto* waiter = static_cast<Wait*>(chain);
+        chain = std::exchange(chain->next, nullptr);
+
+        // Woken waiters queue up for the mutex before resuming
+        AsyncMutex* mutex = waiter->mutex;
+        mutex->waiters_.push(waiter);
+        mutex->waiters_.drain([mutex](AsyncWaiter& /*waiter*/) { return mutex->try_lock(); });
+    }
+}
+
+} // namespace vial
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "io/io_awaitables.hh"
+
+namespace vial {
+
+//! Parked task in an AsyncWaitQueue. The node is the awaitable the worker owns until the task
+//! is resumed, so parking doesn't allocate beyond the usual clone.
+struct AsyncWaiter : IOAwaitable {
+    AsyncWaiter* next = nullptr;
+    std::function<void()> resume;
+};
+
+//! FIFO of suspended tasks shared by the async synchronisation primitives.
+//! Releasers bump their own atomic state first and only take the queue lock when `waiting`
+//! says someone is parked; waiters register first and then retry the acquisition, so at
+//! least one of the two always sees the other.
+class AsyncWaitQueue {
+  public:
+    //! Number of parked waiters, for lock-free fast paths.
+    [[nodiscard]] auto waiting() const noexcept -> size_t { return waiting_.load(); }
+
+    //! Append `waiter` to the queue.
+    void push(AsyncWaiter* waiter);
+
+    //! Resume waiters in FIFO order for as long as `try_acquire(waiter)` grants them the resource.
+    //! Returns the number of waiters resumed.
+    template <typename TryAcquire>
+    auto drain(TryAcquire&& try_acquire) -> size_t {
+        AsyncWaiter* ready = nullptr;
+        AsyncWaiter** tail = &ready;
+        size_t count = 0;
+        {
+            std::lock_guard guard(lock_);
+            while (head_ != nullptr && try_acquire(*head_)) {
+                *tail = pop();
+                tail = &(*tail)->next;
+                count++;
+            }
+        }
+        resume_all(ready);
+        return count;
+    }
+
+    //! Resume every waiter for which `ready(waiter)` holds, wherever it is in the queue.
+    //! Returns the number of waiters resumed.
+    template <typename Ready>
+    auto drain_matching(Ready&& ready) -> size_t {
+        AsyncWaiter* matched = nullptr;
+        AsyncWaiter** tail = &matched;
+        size_t count = 0;
+        {
+            std::lock_guard guard(lock_);
+            AsyncWaiter* previous = nullptr;
+            AsyncWaiter* waiter = head_;
+            while (waiter != nullptr) {
+                AsyncWaiter* next = waiter->next;
+                if (ready(*waiter)) {
+                    unlink(previous, waiter);
+                    *tail = waiter;
+                    tail = &waiter->next;
+                    count++;
+                } else {
+                    previous = waiter;
+                }
+                waiter = next;
+            }
+        }
+        resume_all(matched);
+        return count;
+    }
+
+    //! Unlink up to `count` waiters from the front, without resuming them.
+    [[nodiscard]] auto take(size_t count) -> AsyncWaiter*;
+
+    //! Resume a chain of unlinked waiters.
+    static void resume_all(AsyncWaiter* chain);
+
+  private:
+    auto pop() -> AsyncWaiter*;
+    void unlink(AsyncWaiter* previous, AsyncWaiter* waiter);
+
+    std::mutex lock_;
+    AsyncWaiter* head_ = nullptr;
+    AsyncWaiter* tail_ = nullptr;
+    std::atomic<size_t> waiting_ = 0;
+};
+
+class AsyncMutex;
+
+//! Unlocks an AsyncMutex when destroyed.
+class AsyncLockGuard {
+  public:
+    AsyncLockGuard() = default;
+    explicit AsyncLockGuard(AsyncMutex* mutex) : mutex_(mutex) {}
+
+    AsyncLockGuard(AsyncLockGuard&& other) noexcept : mutex_(std::exchange(other.mutex_, nullptr)) {}
+    auto operator=(AsyncLockGuard&& other) noexcept -> AsyncLockGuard&;
+
+    AsyncLockGuard(const AsyncLockGuard&) = delete;
+    auto operator=(const AsyncLockGuard&) -> AsyncLockGuard& = delete;
+
+    ~AsyncLockGuard() { unlock(); }
+
+    //! Unlock early.
+    void unlock();
+
+  private:
+    AsyncMutex* mutex_ = nullptr;
+};
+
+//! Mutex for state shared between tasks. Contended `lock`s suspend the task instead of
+//! blocking the worker thread, and `unlock` hands the mutex straight to the oldest waiter.
+//! Waits are not cancellable: critical sections are expected to be short.
+class AsyncMutex {
+  public:
+    AsyncMutex() = default;
+
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex(AsyncMutex&&) = delete;
+    auto operator=(const AsyncMutex&) -> AsyncMutex& = delete;
+    auto operator=(AsyncMutex&&) -> AsyncMutex& = delete;
+    ~AsyncMutex() = default;
+
+    //! Take the mutex if it is free.
+    [[nodiscard]] auto try_lock() noexcept -> bool {
+        bool expected = false;
+        return locked_.compare_exchange_strong(expected, true);
+    }
+
+    //! Release the mutex, resuming the next waiter (if any) as its owner.
+    void unlock();
+
+    //! Awaitable that suspends until the mutex is taken.
+    struct Lock : AsyncWaiter {
+        AsyncMutex* mutex;
+
+        explicit Lock(AsyncMutex* owner) : mutex(owner) {}
+
+        [[nodiscard]] auto await_ready() const noexcept -> bool { return mutex->try_lock(); }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = this->clone();
+        }
+
+        void await_resume() const noexcept {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override {
+            return new Lock(mutex);
+        }
+
+        void register_with_event_loop(std::function<void()> callback) override;
+    };
+
+    //! `Lock` that yields a guard unlocking the mutex when it goes out of scope.
+    struct ScopedLock : Lock {
+        using Lock::Lock;
+
+        [[nodiscard]] auto await_resume() const noexcept -> AsyncLockGuard { return AsyncLockGuard{mutex}; }
+    };
+
+    //! e.g. `co_await mutex.lock(); ...; mutex.unlock();`
+    [[nodiscard]] auto lock() -> Lock { return Lock{this}; }
+
+    //! e.g. `auto guard = co_await mutex.scoped_lock();`
+    [[nodiscard]] auto scoped_lock() -> ScopedLock { return ScopedLock{this}; }
+
+  private:
+    friend class AsyncCondVar;
+
+    std::atomic<bool> locked_ = false;
+    AsyncWaitQueue waiters_;
+};
+
+//! Counting semaphore whose `acquire` suspends the task while no permits are left.
+//! Released permits go to waiters in FIFO order. Waits are not cancellable.
+class AsyncSemaphore {
+  public:
+    explicit AsyncSemaphore(size_t permits) : permits_(permits) {}
+
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore(AsyncSemaphore&&) = delete;
+    auto operator=(const AsyncSemaphore&) -> AsyncSemaphore& = delete;
+    auto operator=(AsyncSemaphore&&) -> AsyncSemaphore& = delete;
+    ~AsyncSemaphore() = default;
+
+    //! Take a permit if one is available.
+    [[nodiscard]] auto try_acquire() noexcept -> bool;
+
+    //! Return `count` permits, resuming waiters that can now proceed.
+    void release(size_t count = 1);
+
+    //! Number of permits currently available.
+    [[nodiscard]] auto available() const noexcept -> size_t { return permits_.load(); }
+
+    //! Awaitable that suspends until a permit is taken.
+    struct Acquire : AsyncWaiter {
+        AsyncSemaphore* semaphore;
+
+        explicit Acquire(AsyncSemaphore* owner) : semaphore(owner) {}
+
+        [[nodiscard]] auto await_ready() const noexcept -> bool { return semaphore->try_acquire(); }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = this->clone();
+        }
+
+        void await_resume() const noexcept {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override {
+            return new Acquire(semaphore);
+        }
+
+        void register_with_event_loop(std::function<void()> callback) override;
+    };
+
+    //! e.g. `co_await semaphore.acquire(); ...; semaphore.release();`
+    [[nodiscard]] auto acquire() -> Acquire { return Acquire{this}; }
+
+  private:
+    std::atomic<size_t> permits_;
+    AsyncWaitQueue waiters_;
+};
+
+//! Condition variable for tasks holding an AsyncMutex.
+//! `co_await cv.wait(mutex)` releases the mutex, suspends until notified and resumes with the
+//! mutex held again. As with std::condition_variable, notifications with no waiter are lost
+//! and waiters should re-check their predicate in a loop.
+class AsyncCondVar {
+  public:
+    AsyncCondVar() = default;
+
+    AsyncCondVar(const AsyncCondVar&) = delete;
+    AsyncCondVar(AsyncCondVar&&) = delete;
+    auto operator=(const AsyncCondVar&) -> AsyncCondVar& = delete;
+    auto operator=(AsyncCondVar&&) -> AsyncCondVar& = delete;
+    ~AsyncCondVar() = default;
+
+    //! Wake the oldest waiter.
+    void notify_one() { notify(1); }
+
+    //! Wake every waiter.
+    void notify_all() { notify(SIZE_MAX); }
+
+    //! Awaitable that releases the mutex and suspends until notified.
+    struct Wait : AsyncWaiter {
+        AsyncCondVar* condvar;
+        AsyncMutex* mutex;
+
+        Wait(AsyncCondVar* owner, AsyncMutex* held) : condvar(owner), mutex(held) {}
+
+        [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = this->clone();
+        }
+
+        void await_resume() const noexcept {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override {
+            return new Wait(condvar, mutex);
+        }
+
+        void register_with_event_loop(std::function<void()> callback) override;
+    };
+
+    //! Wait for a notification. `mutex` must be held by the calling task.
+    [[nodiscard]] auto wait(AsyncMutex& mutex) -> Wait { return Wait{this, &mutex}; }
+
+  private:
+    void notify(size_t count);
+
+    AsyncWaitQueue waiters_;
+};
+
+} // namespace vial
@@ -2,13 +2,33 @@
 
 #include <coroutine>
 #include <atomic>
+#include <exception>
 #include <iostream>
 #include <type_traits>
+#include <utility>
+
+#include "cancellation.hh"
+#include "priority.hh"
 
 namespace vial {
 
 // Forward declaration
 class IOAwaitable;
+class TaskBase;
+
+//! Hook run by the Scheduler when a task completes, before its callback is resumed or it is
+//! destroyed. Lets a group of tasks share one completion path (see TaskGroup).
+class CompletionHook {
+  public:
+    CompletionHook() = default;
+    CompletionHook(const CompletionHook&) = delete;
+    CompletionHook(CompletionHook&&) = delete;
+    auto operator=(const CompletionHook&) -> CompletionHook& = delete;
+    auto operator=(CompletionHook&&) -> CompletionHook& = delete;
+    virtual ~CompletionHook() = default;
+
+    virtual void on_complete(TaskBase& task) noexcept = 0;
+};
 
 enum TaskState : std::uint8_t {
   kAwaiting,
@@ -68,11 +88,29 @@ class TaskBase {
     [[nodiscard]] virtual auto get_callback() const -> TaskBase* = 0;
     virtual void set_callback(TaskBase*) = 0;
 
+    //! Hook to run when the task completes, if any.
+    [[nodiscard]] virtual auto get_completion_hook() const -> CompletionHook* = 0;
+    virtual void set_completion_hook(CompletionHook* hook) = 0;
+
+    //! Exception that escaped the coroutine, if any (rethrown by `co_await`).
+    [[nodiscard]] virtual auto get_exception() const -> std::exception_ptr = 0;
+
+    //! Cancellation token of the task (inherited from the task that created it).
+    [[nodiscard]] virtual auto get_cancellation_token() const -> const CancellationToken& = 0;
+    virtual void set_cancellation_token(CancellationToken token) = 0;
+
+    //! Scheduling priority of the task (inherited from the task that created it).
+    [[nodiscard]] virtual auto get_priority() const -> TaskPriority = 0;
+    virtual void set_priority(TaskPriority priority) = 0;
+
     //! Destroys the underlying coroutine (this should happen on co_return).
     virtual void destroy() = 0;
     virtual void print_promise_addr() = 0;
 
     virtual ~TaskBase() = default;
+
+    //! Link used while the task waits in a worker's Inbox.
+    TaskBase* inbox_next = nullptr;
 };
 
 //! Task<T> wraps a std::coroutine_handle to provide callback logic. 
@@ -98,14 +136,20 @@ class Task : public TaskBase {
             state_ = kComplete;
         }
 
-        //! Handler for unhandled exceptions. 
-        void unhandled_exception() {}
+        //! Handler for unhandled exceptions - completes the task, `co_await` rethrows.
+        void unhandled_exception() {
+            exception_ = std::current_exception();
+            state_ = kComplete;
+        }
 
         //! return reference to the task currently awaiting.
         auto get_awaiting() -> TaskBase*& { return awaiting_; }
 
         //! return reference to the IOAwaitable currently suspended.
         auto get_io_awaitable() -> IOAwaitable*& { return io_awaitable_; }
+
+        //! return reference to the cancellation token of the task.
+        auto get_cancellation_token() -> CancellationToken& { return token_; }
         
         void set_state(TaskState state) { state_ = state; }
         
@@ -121,12 +165,23 @@ class Task : public TaskBase {
           // To be added back to queue on completion.
           TaskBase* callback_ = nullptr;
 
+          // Run by the scheduler on completion (e.g. a TaskGroup join counter)
+          CompletionHook* completion_hook_ = nullptr;
+
+          std::exception_ptr exception_;
+
           //! Whether the task should be deleted on completion.
           //! Should be set to true for fire and forget tasks.
           std::atomic<bool> delete_on_completion_ = false;
           
           std::atomic<bool> enqueued_ = false;
 
+          // Inherited from the task running when this one was created
+          CancellationToken token_ = CancellationToken::current();
+
+          // Inherited like the token
+          TaskPriority priority_ = current_priority();
+
           T result_{};
           
         friend Task<T>;
@@ -155,7 +210,8 @@ class Task : public TaskBase {
 
       co_await foo(); // the value here is the return value of await_resume();
     */
-    auto await_resume() noexcept -> T {
+    auto await_resume() -> T {
+      if (handle_.promise().exception_) { std::rethrow_exception(handle_.promise().exception_); }
       return std::move(handle_.promise().result_);
     }
 
@@ -247,6 +303,41 @@ class Task : public TaskBase {
       return this->handle_.promise().callback_;
     }
 
+    //!
+    [[nodiscard]] auto get_completion_hook () const -> CompletionHook* override {
+      return this->handle_.promise().completion_hook_;
+    }
+
+    //!
+    void set_completion_hook (CompletionHook* hook) override {
+      this->handle_.promise().completion_hook_ = hook;
+    }
+
+    //!
+    [[nodiscard]] auto get_exception () const -> std::exception_ptr override {
+      return this->handle_.promise().exception_;
+    }
+
+    //!
+    [[nodiscard]] auto get_cancellation_token () const -> const CancellationToken& override {
+      return this->handle_.promise().token_;
+    }
+
+    //! Set before spawning the task so everything it creates inherits the token.
+    void set_cancellation_token (CancellationToken token) override {
+      this->handle_.promise().token_ = std::move(token);
+    }
+
+    //!
+    [[nodiscard]] auto get_priority () const -> TaskPriority override {
+      return this->handle_.promise().priority_;
+    }
+
+    //! Set before spawning the task; tasks it creates inherit the priority.
+    void set_priority (TaskPriority priority) override {
+      this->handle_.promise().priority_ = priority;
+    }
+
     //!
     void print_promise_addr() override {
       std::cout << handle_.address() << std::endl;
@@ -279,11 +370,16 @@ class Task<void> : public TaskBase {
             state_ = kComplete;
         }
 
-        void unhandled_exception() {}
+        void unhandled_exception() {
+            exception_ = std::current_exception();
+            state_ = kComplete;
+        }
 
         auto get_awaiting() -> TaskBase*& { return awaiting_; }
 
         auto get_io_awaitable() -> IOAwaitable*& { return io_awaitable_; }
+
+        auto get_cancellation_token() -> CancellationToken& { return token_; }
         
         void set_state(TaskState state) { state_ = state; }
         
@@ -291,8 +387,12 @@ class Task<void> : public TaskBase {
         TaskBase* awaiting_ = nullptr;
         IOAwaitable* io_awaitable_ = nullptr;
         TaskBase* callback_ = nullptr;
+        CompletionHook* completion_hook_ = nullptr;
+        std::exception_ptr exception_;
         std::atomic<bool> delete_on_completion_ = false;
         std::atomic<bool> enqueued_ = false;
+        CancellationToken token_ = CancellationToken::current();
+        TaskPriority priority_ = current_priority();
           
         friend Task<void>;
     };
@@ -307,8 +407,8 @@ class Task<void> : public TaskBase {
       awaitee_awaiting = this->clone();
     }
 
-    void await_resume() noexcept {
-      // No value to return for void tasks
+    void await_resume() {
+      if (handle_.promise().exception_) { std::rethrow_exception(handle_.promise().exception_); }
     }
 
     explicit Task(const typename promise_type::Handle coroutine) : handle_{coroutine} {}
@@ -390,6 +490,34 @@ class Task<void> : public TaskBase {
       return this->handle_.promise().callback_;
     }
 
+    [[nodiscard]] auto get_completion_hook () const -> CompletionHook* override {
+      return this->handle_.promise().completion_hook_;
+    }
+
+    void set_completion_hook (CompletionHook* hook) override {
+      this->handle_.promise().completion_hook_ = hook;
+    }
+
+    [[nodiscard]] auto get_exception () const -> std::exception_ptr override {
+      return this->handle_.promise().exception_;
+    }
+
+    [[nodiscard]] auto get_cancellation_token () const -> const CancellationToken& override {
+      return this->handle_.promise().token_;
+    }
+
+    void set_cancellation_token (CancellationToken token) override {
+      this->handle_.promise().token_ = std::move(token);
+    }
+
+    [[nodiscard]] auto get_priority () const -> TaskPriority override {
+      return this->handle_.promise().priority_;
+    }
+
+    void set_priority (TaskPriority priority) override {
+      this->handle_.promise().priority_ = priority;
+    }
+
     void print_promise_addr() override {
       std::cout << handle_.address() << std::endl;
     }
@@ -0,0 +1,58 @@
+#include "task_group.hh"
+#include <cassert>
+#include <utility>
+
+namespace vial {
+
+TaskGroup::TaskGroup(Scheduler& scheduler)
+    : scheduler_(scheduler), state_(std::make_shared<State>()), parent_(CancellationToken::current()) {
+    parent_link_ = parent_.on_cancel([token = state_->token]() { token.cancel(); });
+}
+
+TaskGroup::~TaskGroup() {
+    parent_.remove(parent_link_);
+
+    std::lock_guard guard(state_->lock);
+    assert(state_->pending.load() == 0 && "TaskGroup destroyed before join");
+    if (state_->pending.load() > 0) {
+        state_->keep_alive = state_;
+        state_->token.cancel();
+    }
+}
+
+void TaskGroup::State::on_complete(TaskBase& task) noexcept {
+    auto exception = task.get_exception();
+    if (exception) {
+        // Siblings stop at their next wait
+        token.cancel();
+    }
+
+    std::function<void()> resume;
+    std::shared_ptr<State> self;
+    {
+        // Decrement under the lock: once it is released the group may free the state
+        std::lock_guard guard(lock);
+        if (exception && !error) { error = exception; }
+        if (pending.fetch_sub(1) != 1) { return; }
+
+        resume = std::exchange(joiner, nullptr);
+        self = std::move(keep_alive);
+    }
+
+    // `self` may be the last reference, so nothing touches the state after this
+    if (resume) { resume(); }
+}
+
+void TaskGroup::Join::register_with_event_loop(std::function<void()> callback) {
+    {
+        std::lock_guard guard(state->lock);
+        // The last child may have completed after `await_ready`
+        if (state->pending.load() > 0) {
+            state->joiner = std::move(callback);
+            return;
+        }
+    }
+    callback();
+}
+
+} // namespace vial
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "cancellation.hh"
+#include "io/io_awaitables.hh"
+#include "scheduler.hh"
+#include "task.hh"
+
+namespace vial {
+
+//! Owns a set of spawned child tasks (a nursery).
+//! Children run concurrently under the group's cancellation token, which is cancelled when any
+//! child fails (its exception escapes) or when the task that created the group is cancelled.
+//! `co_await group.join()` resumes once every child has completed and rethrows the first failure.
+//! Children complete through a single shared counter rather than one awaiting task per child.
+//! Joining is mandatory: a destructor can't co_await, so the group can't join on scope exit by
+//! itself. Use `with_task_group` for a scope that always joins. Destroying a group with children
+//! still running is a bug; debug builds assert, release builds cancel the children and let them
+//! finish on their own.
+class TaskGroup {
+  public:
+    explicit TaskGroup(Scheduler& scheduler);
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup(TaskGroup&&) = delete;
+    auto operator=(const TaskGroup&) -> TaskGroup& = delete;
+    auto operator=(TaskGroup&&) -> TaskGroup& = delete;
+
+    ~TaskGroup();
+
+    //! Start `task` as a child of the group. Its result is discarded.
+    template <typename T>
+    void spawn(Task<T> task) {
+        task.set_cancellation_token(state_->token);
+        task.set_completion_hook(state_.get());
+        state_->pending.fetch_add(1);
+        scheduler_.fire_and_forget(task);
+    }
+
+    //! Cancel every child.
+    void cancel() const { state_->token.cancel(); }
+
+    //! Cancellation token shared by the children.
+    [[nodiscard]] auto token() const -> const CancellationToken& { return state_->token; }
+
+    //! Number of children still running.
+    [[nodiscard]] auto size() const -> size_t { return state_->pending.load(); }
+
+  private:
+    //! Join counter shared with the children (outlives the group if they do)
+    struct State : CompletionHook {
+        CancellationToken token = CancellationToken::create();
+        std::atomic<size_t> pending = 0;
+
+        std::mutex lock;
+        std::exception_ptr error;
+        std::function<void()> joiner;
+
+        // Set when the group is destroyed with children still running
+        std::shared_ptr<State> keep_alive;
+
+        void on_complete(TaskBase& task) noexcept override;
+    };
+
+  public:
+    //! Awaitable that suspends until every child has completed.
+    struct Join : IOAwaitable {
+        std::shared_ptr<State> state;
+
+        explicit Join(std::shared_ptr<State> group_state) : state(std::move(group_state)) {}
+
+        [[nodiscard]] auto await_ready() const noexcept -> bool { return state->pending.load() == 0; }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = this->clone();
+        }
+
+        //! Rethrows the first exception that escaped a child
+        void await_resume() const {
+            std::lock_guard guard(state->lock);
+            if (state->error) { std::rethrow_exception(state->error); }
+        }
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override {
+            return new Join(state);
+        }
+
+        void register_with_event_loop(std::function<void()> callback) override;
+    };
+
+    //! Wait for every child to complete.
+    [[nodiscard]] auto join() const -> Join { return Join{state_}; }
+
+  private:
+    Scheduler& scheduler_;
+    std::shared_ptr<State> state_;
+
+    // Cancelling the creating task cancels the children
+    CancellationToken parent_;
+    uint64_t parent_link_ = 0;
+};
+
+//! Run `body(group)` with a new TaskGroup and join the group before completing, even if `body`
+//! throws (the children are then cancelled). Rethrows the exception of `body`, or else the first
+//! failure of a child.
+//! e.g. `co_await with_task_group(scheduler, [&](TaskGroup& group) -> Task<void> { ... });`
+template <typename F>
+auto with_task_group(Scheduler& scheduler, F body) -> Task<void> {
+    TaskGroup group{scheduler};
+    std::exception_ptr error;
+    try {
+        co_await body(group);
+    } catch (...) {
+        error = std::current_exception();
+        group.cancel();
+    }
+
+    if (error) {
+        // The body's failure wins over the ones it caused in the children
+        try {
+            co_await group.join();
+        } catch (...) {} // NOLINT
+        std::rethrow_exception(error);
+    }
+    co_await group.join();
+}
+
+} // namespace vial
@@ -0,0 +1,178 @@
+#include "timer_wheel.hh"
+#include <algorithm>
+#include <utility>
+
+namespace vial {
+
+namespace {
+
+constexpr uint64_t kSlotMask = kTimerWheelSlots - 1;
+
+//! Ticks covered by the whole wheel
+constexpr uint64_t kWheelSpan = uint64_t{1} << (kTimerWheelBits * kTimerWheelLevels);
+
+thread_local TimerWheel* current_wheel = nullptr;
+
+void unlink(TimerLink& link) {
+    link.prev->next = link.next;
+    link.next->prev = link.prev;
+    link.prev = &link;
+    link.next = &link;
+}
+
+void push_back(TimerLink& list, TimerLink& link) {
+    link.prev = list.prev;
+    link.next = &list;
+    list.prev->next = &link;
+    list.prev = &link;
+}
+
+} // namespace
+
+TimerEntry::~TimerEntry() {
+    cancel();
+}
+
+auto TimerEntry::cancel() -> bool {
+    TimerWheel* wheel = wheel_.load();
+    if (wheel == nullptr) { return false; }
+
+    std::function<void()> callback;
+    {
+        std::lock_guard guard(wheel->lock_);
+        // Fired (or cancelled) between the load and taking the lock
+        if (wheel_.load() != wheel) { return false; }
+
+        unlink(*this);
+        wheel_ = nullptr;
+        wheel->size_.fetch_sub(1, std::memory_order_relaxed);
+        callback = std::move(callback_);
+    }
+    return true;
+}
+
+TimerWheel::TimerWheel(TimerClock::time_point start) : start_(start) {}
+
+TimerWheel::~TimerWheel() {
+    std::lock_guard guard(lock_);
+    for (auto& level : slots_) {
+        for (auto& slot : level) {
+            while (slot.next != &slot) {
+                auto* entry = static_cast<TimerEntry*>(slot.next);
+                unlink(*entry);
+                entry->wheel_ = nullptr;
+            }
+        }
+    }
+}
+
+auto TimerWheel::current() -> TimerWheel* {
+    return current_wheel;
+}
+
+void TimerWheel::set_current(TimerWheel* wheel) {
+    current_wheel = wheel;
+}
+
+auto TimerWheel::to_tick(TimerClock::time_point time_point) const -> uint64_t {
+    if (time_point <= start_) { return 0; }
+    auto elapsed = time_point - start_;
+    return static_cast<uint64_t>((elapsed + kTimerTick - TimerClock::duration{1}) / kTimerTick);
+}
+
+void TimerWheel::schedule(TimerEntry& entry, TimerClock::time_point deadline, std::function<void()> callback) {
+    uint64_t tick = to_tick(deadline);
+
+    std::lock_guard guard(lock_);
+    // Already due deadlines fire on the next tick
+    entry.expiry_ = std::max(tick, current_tick_ + 1);
+    entry.callback_ = std::move(callback);
+    entry.wheel_ = this;
+    insert(entry);
+    size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TimerWheel::insert(TimerEntry& entry) {
+    uint64_t placement = std::max(entry.expiry_, current_tick_);
+    uint64_t delta = placement - current_tick_;
+
+    // Beyond the top level: park in the furthest slot and cascade again from there
+    if (delta >= kWheelSpan) {
+        placement = current_tick_ + kWheelSpan - 1;
+        delta = kWheelSpan - 1;
+    }
+
+    size_t level = 0;
+    while (delta >= (uint64_t{1} << (kTimerWheelBits * (level + 1)))) { level++; }
+
+    auto index = static_cast<size_t>((placement >> (kTimerWheelBits * level)) & kSlotMask);
+    push_back(slots_.at(level).at(index), entry);
+}
+
+void TimerWheel::splice(TimerLink& slot, TimerLink& out) {
+    if (slot.next == &slot) { return; }
+
+    slot.next->prev = out.prev;
+    slot.prev->next = &out;
+    out.prev->next = slot.next;
+    out.prev = slot.prev;
+
+    slot.prev = &slot;
+    slot.next = &slot;
+}
+
+auto TimerWheel::advance(TimerClock::time_point now) -> size_t {
+    if (now <= start_) { return 0; }
+    auto target = static_cast<uint64_t>((now - start_) / kTimerTick);
+
+    // Only this wheel's worker moves the current tick, so it can check without the lock
+    if (target <= current_tick_) { return 0; }
+
+    size_t fired = 0;
+    std::unique_lock guard(lock_);
+
+    while (current_tick_ < target) {
+        if (size_.load(std::memory_order_relaxed) == 0) {
+            current_tick_ = target;
+            break;
+        }
+
+        current_tick_++;
+
+        // Each time a level wraps around, pull the next slot of the level above down
+        for (size_t level = 1; level < kTimerWheelLevels; level++) {
+            uint64_t lower_bits = (uint64_t{1} << (kTimerWheelBits * level)) - 1;
+            if ((current_tick_ & lower_bits) != 0) { break; }
+
+            auto index = static_cast<size_t>((current_tick_ >> (kTimerWheelBits * level)) & kSlotMask);
+            TimerLink cascading;
+            splice(slots_.at(level).at(index), cascading);
+            while (cascading.next != &cascading) {
+                auto* entry = static_cast<TimerEntry*>(cascading.next);
+                unlink(*entry);
+                insert(*entry);
+            }
+        }
+
+        TimerLink due;
+        splice(slots_.at(0).at(current_tick_ & kSlotMask), due);
+
+        // Entries stay linked into `due` until they run, so a concurrent cancel can still unlink them
+        while (due.next != &due) {
+            auto* entry = static_cast<TimerEntry*>(due.next);
+            unlink(*entry);
+            entry->wheel_ = nullptr;
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            auto callback = std::move(entry->callback_);
+
+            guard.unlock();
+            callback();
+            fired++;
+            guard.lock();
+        }
+    }
+
+    return fired;
+}
+
+} // namespace vial
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace vial {
+
+using TimerClock = std::chrono::steady_clock;
+
+//! Resolution of the TimerWheel. Deadlines are rounded up to the next tick.
+constexpr TimerClock::duration kTimerTick = std::chrono::milliseconds(1);
+
+//! Slots per level of the TimerWheel (must be a power of two).
+constexpr size_t kTimerWheelBits = 6;
+constexpr size_t kTimerWheelSlots = size_t{1} << kTimerWheelBits;
+
+//! Levels of the TimerWheel. Level `l` covers deltas below kTimerWheelSlots^(l+1) ticks,
+//! so 4 levels of 64 slots at 1ms reach ~4.6 hours; later deadlines are cascaded again.
+constexpr size_t kTimerWheelLevels = 4;
+
+class TimerWheel;
+
+//! Intrusive doubly linked list node, used both by entries and by the slot list heads.
+struct TimerLink {
+    TimerLink* prev = this;
+    TimerLink* next = this;
+};
+
+//! A pending timer. Owned by whoever schedules it (typically an awaitable) and linked into a
+//! TimerWheel slot, so scheduling and cancelling never allocate.
+//! Destroying a pending entry cancels it.
+class TimerEntry : TimerLink {
+  public:
+    TimerEntry() = default;
+    TimerEntry(const TimerEntry&) = delete;
+    TimerEntry(TimerEntry&&) = delete;
+    auto operator=(const TimerEntry&) -> TimerEntry& = delete;
+    auto operator=(TimerEntry&&) -> TimerEntry& = delete;
+    ~TimerEntry();
+
+    //! Cancel the timer if it's still pending. Returns true if it was (its callback won't run).
+    //! Safe to call from any thread.
+    auto cancel() -> bool;
+
+    //! Check if the timer is scheduled and hasn't fired or been cancelled yet.
+    [[nodiscard]] auto is_pending() const -> bool { return wheel_.load() != nullptr; }
+
+  private:
+    friend class TimerWheel;
+
+    std::atomic<TimerWheel*> wheel_ = nullptr;
+    uint64_t expiry_ = 0;
+    std::function<void()> callback_;
+};
+
+//! Hierarchical timer wheel (kTimerWheelLevels levels of kTimerWheelSlots slots).
+//! Insert and cancel are O(1); each timer is cascaded down at most once per level.
+//! Every Scheduler worker owns one and advances it from its run loop, so timers fire on
+//! the worker that scheduled them. Cancellation may come from any thread.
+class TimerWheel {
+  public:
+    explicit TimerWheel(TimerClock::time_point start = TimerClock::now());
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    auto operator=(const TimerWheel&) -> TimerWheel& = delete;
+    auto operator=(TimerWheel&&) -> TimerWheel& = delete;
+
+    //! Pending entries are detached (they will never fire).
+    ~TimerWheel();
+
+    //! Run `callback` once `deadline` has passed. `entry` must not be pending and must stay
+    //! alive until it fires or is cancelled.
+    void schedule(TimerEntry& entry, TimerClock::time_point deadline, std::function<void()> callback);
+
+    //! Fire every timer due at `now`. Returns the number of callbacks run.
+    auto advance(TimerClock::time_point now) -> size_t;
+
+    //! Number of pending timers.
+    [[nodiscard]] auto size() const -> size_t { return size_.load(std::memory_order_relaxed); }
+
+    //! Wheel of the Scheduler worker running on this thread, or nullptr.
+    static auto current() -> TimerWheel*;
+    static void set_current(TimerWheel* wheel);
+
+  private:
+    friend class TimerEntry;
+
+    //! Link `entry` into the slot for its expiry. Requires `lock_`.
+    void insert(TimerEntry& entry);
+
+    //! Move every entry in `slot` into `out`. Requires `lock_`.
+    static void splice(TimerLink& slot, TimerLink& out);
+
+    //! Tick at or after `time_point`
+    [[nodiscard]] auto to_tick(TimerClock::time_point time_point) const -> uint64_t;
+
+    TimerClock::time_point start_;
+    uint64_t current_tick_ = 0;
+    std::atomic<size_t> size_ = 0;
+
+    std::array<std::array<TimerLink, kTimerWheelSlots>, kTimerWheelLevels> slots_{};
+
+    // Cancellation may race with firing from another thread
+    std::mutex lock_;
+};
+
+} // namespace vial
@@ -0,0 +1,56 @@
+#include "wait_group.hh"
+#include <utility>
+
+namespace vial {
+
+void ZeroWait::Node::register_with_event_loop(std::function<void()> callback) {
+    // Another thread may resume the task (and free this node) as soon as it is queued
+    const std::atomic<size_t>* counter = count;
+    AsyncWaitQueue* queue = waiters;
+    resume = std::move(callback);
+    queue->push(this);
+
+    // The count may have reached zero before this waiter was visible
+    release(*counter, *queue);
+}
+
+void ZeroWait::release(const std::atomic<size_t>& count, AsyncWaitQueue& waiters) {
+    if (waiters.waiting() > 0 && count.load() == 0) {
+        waiters.drain([&count](AsyncWaiter& /*waiter*/) { return count.load() == 0; });
+    }
+}
+
+void WaitGroup::done() {
+    if (count_.fetch_sub(1) == 1) { ZeroWait::release(count_, waiters_); }
+}
+
+void Latch::count_down(size_t count) {
+    if (count_.fetch_sub(count) == count) { ZeroWait::release(count_, waiters_); }
+}
+
+auto Barrier::arrive(uint32_t& phase) -> bool {
+    uint64_t state = state_.fetch_add(1);
+    phase = static_cast<uint32_t>(state >> 32);
+    if (static_cast<uint32_t>(state) + 1 < count_) { return false; }
+
+    // Last arrival: open the next phase, then release this one
+    state_.store(static_cast<uint64_t>(phase + 1) << 32);
+    if (waiters_.waiting() > 0) { waiters_.drain_matching(released); }
+    return true;
+}
+
+auto Barrier::released(AsyncWaiter& waiter) -> bool {
+    auto& node = static_cast<Arrive::Node&>(waiter);
+    return node.barrier->phase() != node.phase;
+}
+
+void Barrier::Arrive::Node::register_with_event_loop(std::function<void()> callback) {
+    Barrier* owner = barrier;
+    resume = std::move(callback);
+    owner->waiters_.push(this);
+
+    // The phase may have completed before this waiter was visible
+    owner->waiters_.drain_matching(released);
+}
+
+} // namespace vial
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "io/io_awaitables.hh"
+#include "sync.hh"
+
+namespace vial {
+
+//! Awaitable that suspends until `count` drops to zero, parking on `waiters`.
+struct ZeroWait {
+    //! Parked while the count is positive
+    struct Node : AsyncWaiter {
+        const std::atomic<size_t>* count;
+        AsyncWaitQueue* waiters;
+
+        Node(const std::atomic<size_t>* counter, AsyncWaitQueue* queue) : count(counter), waiters(queue) {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Node(count, waiters); }
+
+        void register_with_event_loop(std::function<void()> callback) override;
+    };
+
+    const std::atomic<size_t>* count;
+    AsyncWaitQueue* waiters;
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return count->load() == 0; }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) noexcept {
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = new Node(count, waiters);
+    }
+
+    void await_resume() const noexcept {}
+
+    //! Resume every waiter if `count` is zero.
+    static void release(const std::atomic<size_t>& count, AsyncWaitQueue& waiters);
+};
+
+//! Counter of outstanding work, for joining a dynamic number of tasks:
+//! `group.add()` before spawning, `group.done()` as each finishes, `co_await group.wait()`.
+//! Unlike a TaskGroup it doesn't own the tasks, so it also works for tasks spawned elsewhere.
+class WaitGroup {
+  public:
+    WaitGroup() = default;
+
+    WaitGroup(const WaitGroup&) = delete;
+    WaitGroup(WaitGroup&&) = delete;
+    auto operator=(const WaitGroup&) -> WaitGroup& = delete;
+    auto operator=(WaitGroup&&) -> WaitGroup& = delete;
+    ~WaitGroup() = default;
+
+    //! Expect `count` more calls to `done`.
+    void add(size_t count = 1) { count_.fetch_add(count); }
+
+    //! Mark one unit of work finished, resuming the waiters on the last one.
+    void done();
+
+    //! Outstanding work.
+    [[nodiscard]] auto count() const noexcept -> size_t { return count_.load(); }
+
+    //! Wait until the count reaches zero.
+    [[nodiscard]] auto wait() -> ZeroWait { return ZeroWait{&count_, &waiters_}; }
+
+  private:
+    std::atomic<size_t> count_ = 0;
+    AsyncWaitQueue waiters_;
+};
+
+//! Single-use countdown: tasks wait until `count_down` has been called `count` times.
+class Latch {
+  public:
+    explicit Latch(size_t count) : count_(count) {}
+
+    Latch(const Latch&) = delete;
+    Latch(Latch&&) = delete;
+    auto operator=(const Latch&) -> Latch& = delete;
+    auto operator=(Latch&&) -> Latch& = delete;
+    ~Latch() = default;
+
+    //! Decrement the counter by `count`, resuming the waiters once it reaches zero.
+    void count_down(size_t count = 1);
+
+    //! Check if the counter has reached zero.
+    [[nodiscard]] auto try_wait() const noexcept -> bool { return count_.load() == 0; }
+
+    //! Wait until the counter reaches zero.
+    [[nodiscard]] auto wait() -> ZeroWait { return ZeroWait{&count_, &waiters_}; }
+
+    //! Count down once and wait for the others.
+    [[nodiscard]] auto arrive_and_wait() -> ZeroWait {
+        count_down();
+        return wait();
+    }
+
+  private:
+    std::atomic<size_t> count_;
+    AsyncWaitQueue waiters_;
+};
+
+//! Reusable rendezvous for `count` tasks working in phases: each `co_await arrive_and_wait()`
+//! suspends until all `count` tasks have arrived, then the last one releases the rest and the
+//! barrier resets for the next phase.
+class Barrier {
+  public:
+    explicit Barrier(uint32_t count) : count_(count) {}
+
+    Barrier(const Barrier&) = delete;
+    Barrier(Barrier&&) = delete;
+    auto operator=(const Barrier&) -> Barrier& = delete;
+    auto operator=(Barrier&&) -> Barrier& = delete;
+    ~Barrier() = default;
+
+    //! Awaitable that arrives at the barrier and waits for the current phase to complete.
+    struct Arrive {
+        //! Parked until the barrier leaves `phase`
+        struct Node : AsyncWaiter {
+            Barrier* barrier;
+            uint32_t phase;
+
+            Node(Barrier* owner, uint32_t arrived_in) : barrier(owner), phase(arrived_in) {}
+
+            [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Node(barrier, phase); }
+
+            void register_with_event_loop(std::function<void()> callback) override;
+        };
+
+        Barrier* barrier;
+        uint32_t phase = 0;
+
+        //! Arrives; ready straight away for the last task of the phase
+        [[nodiscard]] auto await_ready() noexcept -> bool { return barrier->arrive(phase); }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = new Node(barrier, phase);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    [[nodiscard]] auto arrive_and_wait() -> Arrive { return Arrive{this}; }
+
+    //! Number of completed phases.
+    [[nodiscard]] auto phase() const noexcept -> uint32_t { return static_cast<uint32_t>(state_.load() >> 32); }
+
+  private:
+    //! Count an arrival, recording its phase. Returns true if it completed the phase.
+    auto arrive(uint32_t& phase) -> bool;
+
+    //! Whether a parked task's phase has completed (run under the wait queue lock).
+    static auto released(AsyncWaiter& waiter) -> bool;
+
+    const uint32_t count_;
+
+    // Completed phases in the high half, arrivals in the current phase in the low half
+    std::atomic<uint64_t> state_ = 0;
+    AsyncWaitQueue waiters_;
+};
+
+} // namespace vial
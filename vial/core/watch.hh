@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "io/io_awaitables.hh"
+#include "sync.hh"
+
+namespace vial {
+
+//! Latest value shared by a WatchSender and its receivers, with a version bumped on every send.
+template <typename T>
+struct WatchState {
+    explicit WatchState(T initial) : value(std::move(initial)) {}
+
+    std::mutex lock;
+    T value;
+
+    std::atomic<uint64_t> version = 0;
+    std::atomic<bool> closed = false;
+
+    AsyncWaitQueue waiters;
+};
+
+template <typename T>
+class WatchSender;
+
+//! Receiving end of a watch channel. Only the latest value is kept: a receiver that falls
+//! behind sees the newest value once, not every intermediate one.
+template <typename T>
+class WatchReceiver {
+  public:
+    WatchReceiver(std::shared_ptr<WatchState<T>> state, uint64_t seen)
+        : state_(std::move(state)), seen_(seen) {}
+
+    //! Copy of the current value, which is marked as seen.
+    [[nodiscard]] auto get() -> T {
+        std::lock_guard guard(state_->lock);
+        seen_ = state_->version.load();
+        return state_->value;
+    }
+
+    //! Check if a value newer than the last one seen has been sent.
+    [[nodiscard]] auto has_changed() const noexcept -> bool { return seen_ != state_->version.load(); }
+
+    //! Awaitable yielding the next unseen value, or std::nullopt once the sender is gone.
+    struct Changed {
+        //! Parked until the version moves past the receiver's
+        struct Node : AsyncWaiter {
+            WatchReceiver* receiver;
+
+            explicit Node(WatchReceiver* origin) : receiver(origin) {}
+
+            [[nodiscard]] auto clone() const -> IOAwaitable* override { return new Node(receiver); }
+
+            void register_with_event_loop(std::function<void()> callback) override {
+                auto state = receiver->state_;
+                resume = std::move(callback);
+                state->waiters.push(this);
+
+                // A value may have been sent before this receiver was visible
+                state->waiters.drain_matching(ready);
+            }
+        };
+
+        WatchReceiver* receiver;
+
+        [[nodiscard]] auto await_ready() const noexcept -> bool {
+            return receiver->has_changed() || receiver->state_->closed.load();
+        }
+
+        template <typename S>
+        void await_suspend(std::coroutine_handle<S> handle) noexcept {
+            handle.promise().set_state(TaskState::kBlockedOnIO);
+            handle.promise().get_io_awaitable() = new Node(receiver);
+        }
+
+        auto await_resume() -> std::optional<T> {
+            if (!receiver->has_changed()) { return std::nullopt; }
+            return receiver->get();
+        }
+    };
+
+    //! e.g. `while (auto config = co_await watcher.changed()) { apply(*config); }`
+    [[nodiscard]] auto changed() -> Changed { return Changed{this}; }
+
+  private:
+    friend class WatchSender<T>;
+
+    //! Whether a parked receiver has a newer value (run under the wait queue lock).
+    static auto ready(AsyncWaiter& waiter) -> bool {
+        auto* receiver = static_cast<typename Changed::Node&>(waiter).receiver;
+        return receiver->has_changed() || receiver->state_->closed.load();
+    }
+
+    std::shared_ptr<WatchState<T>> state_;
+    uint64_t seen_;
+};
+
+//! Sending end of a watch channel. Destroying the sender closes the channel.
+template <typename T>
+class WatchSender {
+  public:
+    explicit WatchSender(T initial) : state_(std::make_shared<WatchState<T>>(std::move(initial))) {}
+
+    WatchSender(WatchSender&&) noexcept = default;
+    auto operator=(WatchSender&& other) noexcept -> WatchSender& {
+        if (this != &other) {
+            close();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+
+    WatchSender(const WatchSender&) = delete;
+    auto operator=(const WatchSender&) -> WatchSender& = delete;
+
+    ~WatchSender() { close(); }
+
+    //! Replace the value and wake every receiver.
+    void send(T value) {
+        {
+            std::lock_guard guard(state_->lock);
+            state_->value = std::move(value);
+            state_->version.fetch_add(1);
+        }
+        wake();
+    }
+
+    //! New receiver, which considers the current value seen.
+    [[nodiscard]] auto subscribe() const -> WatchReceiver<T> {
+        return WatchReceiver<T>{state_, state_->version.load()};
+    }
+
+    //! Release receivers waiting for a change.
+    void close() {
+        if (state_ == nullptr || state_->closed.exchange(true)) { return; }
+        wake();
+    }
+
+  private:
+    void wake() {
+        if (state_->waiters.waiting() > 0) {
+            state_->waiters.drain_matching(WatchReceiver<T>::ready);
+        }
+    }
+
+    std::shared_ptr<WatchState<T>> state_;
+};
+
+//! Create a watch channel holding `initial`, with a first receiver.
+//! More receivers come from `sender.subscribe()`.
+template <typename T>
+auto watch(T initial) -> std::pair<WatchSender<T>, WatchReceiver<T>> {
+    WatchSender<T> sender{std::move(initial)};
+    WatchReceiver<T> receiver = sender.subscribe();
+    return {std::move(sender), std::move(receiver)};
+}
+
+} // namespace vial
@@ -0,0 +1,51 @@
+#include "when.hh"
+#include <utility>
+
+namespace vial {
+
+auto WhenState::claim(size_t index) noexcept -> bool {
+    if (!any_) { return true; }
+    size_t expected = kNoWinner;
+    return winner_.compare_exchange_strong(expected, index);
+}
+
+void WhenState::arrive(bool claimed, std::exception_ptr exception) noexcept {
+    // when_any completes on the winner, when_all on the last child
+    bool last = remaining_.fetch_sub(1) == 1;
+    bool completes = any_ ? claimed : last;
+    if (completes && any_) { token_.cancel(); }
+
+    std::function<void()> resume;
+    std::shared_ptr<WhenState> self;
+    {
+        std::lock_guard guard(lock_);
+        if (claimed && exception && !error_) { error_ = std::move(exception); }
+        if (completes) {
+            done_ = true;
+            resume = std::exchange(joiner_, nullptr);
+        }
+        if (last) { self = std::move(self_); }
+    }
+
+    // `self` may be the last reference, so nothing touches the state after this
+    if (resume) { resume(); }
+}
+
+void WhenState::register_joiner(std::function<void()> callback) {
+    {
+        std::lock_guard guard(lock_);
+        // The deciding child may have arrived before the worker parked the task
+        if (!done_) {
+            joiner_ = std::move(callback);
+            return;
+        }
+    }
+    callback();
+}
+
+void WhenState::rethrow() const {
+    std::lock_guard guard(lock_);
+    if (error_) { std::rethrow_exception(error_); }
+}
+
+} // namespace vial
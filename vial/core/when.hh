@@ -0,0 +1,292 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "cancellation.hh"
+#include "io/io_awaitables.hh"
+#include "scheduler.hh"
+#include "task.hh"
+
+namespace vial {
+
+//! Value a child contributes to a when_all/when_any result (`void` children yield std::monostate).
+template <typename T>
+using WhenResult = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+//! Countdown shared by the children of a when_all/when_any and the task awaiting them.
+//! Children arrive through their completion hook; only the arrival that completes the wait
+//! (the last one for when_all, the first one for when_any) resumes the parent.
+class WhenState {
+  public:
+    static constexpr size_t kNoWinner = std::numeric_limits<size_t>::max();
+
+    WhenState(size_t children, bool any) : remaining_(children), any_(any) {}
+
+    WhenState(const WhenState&) = delete;
+    WhenState(WhenState&&) = delete;
+    auto operator=(const WhenState&) -> WhenState& = delete;
+    auto operator=(WhenState&&) -> WhenState& = delete;
+
+    virtual ~WhenState() = default;
+
+    //! Claim the child's result slot: always granted for when_all, first come for when_any.
+    auto claim(size_t index) noexcept -> bool;
+
+    //! Record a completed child (after storing its result if `claimed`).
+    void arrive(bool claimed, std::exception_ptr exception) noexcept;
+
+    //! Resume the parent with `callback` once the wait has completed.
+    void register_joiner(std::function<void()> callback);
+
+    //! Rethrow the failure that completed the wait, if any.
+    void rethrow() const;
+
+    //! Index of the child that completed a when_any.
+    [[nodiscard]] auto winner() const noexcept -> size_t { return winner_.load(); }
+
+    //! Cancelled once a when_any has a winner, so the other children stop at their next wait.
+    [[nodiscard]] auto token() const -> const CancellationToken& { return token_; }
+
+    //! Keep the state alive until every child has arrived (they may outlive the parent's wait).
+    void keep_alive(std::shared_ptr<WhenState> self) { self_ = std::move(self); }
+
+  private:
+    std::atomic<size_t> remaining_;
+    std::atomic<size_t> winner_ = kNoWinner;
+    const bool any_;
+
+    CancellationToken token_;
+    CancellationToken parent_;
+    uint64_t parent_link_ = 0;
+
+    mutable std::mutex lock_;
+    bool done_ = false;
+    std::exception_ptr error_;
+    std::function<void()> joiner_;
+    std::shared_ptr<WhenState> self_;
+
+    template <typename Results> friend class WhenAwaitable;
+};
+
+//! Completion hook of one child, storing its result in the shared `Results`.
+template <typename T, typename Results>
+struct WhenChild : CompletionHook {
+    Results* results = nullptr;
+    size_t index = 0;
+
+    void on_complete(TaskBase& task) noexcept override {
+        std::exception_ptr exception = task.get_exception();
+        bool claimed = results->claim(index);
+        if (claimed && !exception) {
+            // The completed task is a clone of the `Task<T>` that was spawned
+            if constexpr (std::is_void_v<T>) {
+                results->store(index, std::monostate{});
+            } else {
+                results->store(index, static_cast<Task<T>&>(task).await_resume());
+            }
+        }
+        results->arrive(claimed, exception);
+    }
+};
+
+//! Awaitable that spawns the children on suspension and resumes once `Results` is complete.
+//! `co_await` yields `Results::take()` or rethrows the failure that completed the wait.
+template <typename Results>
+class WhenAwaitable {
+  public:
+    WhenAwaitable(Scheduler& scheduler, std::shared_ptr<Results> results)
+        : scheduler_(scheduler), results_(std::move(results)) {}
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return results_->empty(); }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) {
+        auto& state = static_cast<WhenState&>(*results_);
+        state.keep_alive(results_);
+
+        if (state.any_) {
+            // Losers are cancelled along with the parent, or as soon as a winner arrives
+            state.token_ = CancellationToken::create();
+            state.parent_ = handle.promise().get_cancellation_token();
+            state.parent_link_ = state.parent_.on_cancel([token = state.token_]() { token.cancel(); });
+        }
+
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = new Join(results_);
+
+        // Children may complete before the worker registers the parent; `register_joiner` checks
+        results_->spawn(scheduler_);
+    }
+
+    auto await_resume() {
+        auto& state = static_cast<WhenState&>(*results_);
+        state.parent_.remove(state.parent_link_);
+        state.rethrow();
+        return results_->take();
+    }
+
+  private:
+    struct Join : IOAwaitable {
+        std::shared_ptr<WhenState> state;
+
+        explicit Join(std::shared_ptr<WhenState> shared) : state(std::move(shared)) {}
+
+        [[nodiscard]] auto clone() const -> IOAwaitable* override {
+            return new Join(state);
+        }
+
+        void register_with_event_loop(std::function<void()> callback) override {
+            state->register_joiner(std::move(callback));
+        }
+    };
+
+    Scheduler& scheduler_;
+    std::shared_ptr<Results> results_;
+};
+
+//! Results of a fixed set of differently typed children.
+template <bool Any, typename... Ts>
+class WhenTuple : public WhenState {
+  public:
+    explicit WhenTuple(Task<Ts>... tasks) : WhenState(sizeof...(Ts), Any), tasks_(tasks...) {}
+
+    [[nodiscard]] auto empty() const -> bool { return sizeof...(Ts) == 0; }
+
+    template <typename V>
+    void store(size_t index, V&& value) {
+        store_at(index, std::forward<V>(value), std::index_sequence_for<Ts...>{});
+    }
+
+    void spawn(Scheduler& scheduler) {
+        spawn_all(scheduler, std::index_sequence_for<Ts...>{});
+    }
+
+    auto take() {
+        if constexpr (Any) {
+            return take_winner(std::index_sequence_for<Ts...>{});
+        } else {
+            return std::move(values_);
+        }
+    }
+
+  private:
+    template <size_t... Is>
+    void spawn_all(Scheduler& scheduler, std::index_sequence<Is...> /*unused*/) {
+        (spawn_one<Is>(scheduler), ...);
+    }
+
+    template <size_t I>
+    void spawn_one(Scheduler& scheduler) {
+        auto& task = std::get<I>(tasks_);
+        auto& hook = std::get<I>(hooks_);
+        hook.results = this;
+        hook.index = I;
+        if constexpr (Any) { task.set_cancellation_token(token()); }
+        task.set_completion_hook(&hook);
+        scheduler.fire_and_forget(task);
+    }
+
+    template <typename V, size_t... Is>
+    void store_at(size_t index, V&& value, std::index_sequence<Is...> /*unused*/) {
+        (store_if<Is>(index, value), ...);
+    }
+
+    template <size_t I, typename V>
+    void store_if(size_t index, V& value) {
+        if constexpr (std::is_same_v<std::decay_t<V>, std::tuple_element_t<I, std::tuple<WhenResult<Ts>...>>>) {
+            if (index == I) { std::get<I>(values_) = std::move(value); }
+        }
+    }
+
+    template <size_t... Is>
+    auto take_winner(std::index_sequence<Is...> /*unused*/) -> std::variant<WhenResult<Ts>...> {
+        std::variant<WhenResult<Ts>...> result;
+        ((winner() == Is ? (result.template emplace<Is>(std::move(std::get<Is>(values_))), 0) : 0), ...);
+        return result;
+    }
+
+    std::tuple<Task<Ts>...> tasks_;
+    std::tuple<WhenChild<Ts, WhenTuple>...> hooks_;
+    std::tuple<WhenResult<Ts>...> values_;
+};
+
+//! Results of a range of children of the same type.
+template <bool Any, typename T>
+class WhenRange : public WhenState {
+  public:
+    explicit WhenRange(std::vector<Task<T>> tasks)
+        : WhenState(tasks.size(), Any), tasks_(std::move(tasks)), hooks_(tasks_.size()), values_(tasks_.size()) {}
+
+    [[nodiscard]] auto empty() const -> bool { return tasks_.empty(); }
+
+    void store(size_t index, WhenResult<T>&& value) { values_[index] = std::move(value); }
+
+    void spawn(Scheduler& scheduler) {
+        for (size_t i = 0; i < tasks_.size(); i++) {
+            hooks_[i].results = this;
+            hooks_[i].index = i;
+            if constexpr (Any) { tasks_[i].set_cancellation_token(token()); }
+            tasks_[i].set_completion_hook(&hooks_[i]);
+            scheduler.fire_and_forget(tasks_[i]);
+        }
+    }
+
+    auto take() {
+        if constexpr (Any) {
+            return std::pair<size_t, WhenResult<T>>{winner(), std::move(values_[winner()])};
+        } else {
+            return std::move(values_);
+        }
+    }
+
+  private:
+    std::vector<Task<T>> tasks_;
+    std::vector<WhenChild<T, WhenRange>> hooks_;
+    std::vector<WhenResult<T>> values_;
+};
+
+//! Run every task concurrently and resume once all of them have completed.
+//! `co_await when_all(scheduler, a(), b())` yields a `std::tuple` of their results and rethrows
+//! the first exception that escaped a child. The tasks must not have been spawned yet.
+template <typename... Ts>
+auto when_all(Scheduler& scheduler, Task<Ts>... tasks) -> WhenAwaitable<WhenTuple<false, Ts...>> {
+    return {scheduler, std::make_shared<WhenTuple<false, Ts...>>(tasks...)};
+}
+
+//! Range form of `when_all`, yielding a `std::vector` of results in the order of `tasks`.
+template <typename T>
+auto when_all(Scheduler& scheduler, std::vector<Task<T>> tasks) -> WhenAwaitable<WhenRange<false, T>> {
+    return {scheduler, std::make_shared<WhenRange<false, T>>(std::move(tasks))};
+}
+
+//! Run every task concurrently and resume as soon as one of them completes.
+//! `co_await` yields a `std::variant` whose index is the winning child (or rethrows its exception).
+//! The other children are cancelled and finish in the background; their results are discarded.
+template <typename... Ts>
+auto when_any(Scheduler& scheduler, Task<Ts>... tasks) -> WhenAwaitable<WhenTuple<true, Ts...>> {
+    static_assert(sizeof...(Ts) > 0, "when_any needs at least one task");
+    return {scheduler, std::make_shared<WhenTuple<true, Ts...>>(tasks...)};
+}
+
+//! Range form of `when_any`, yielding the index of the winning child and its result.
+//! Throws `std::invalid_argument` if `tasks` is empty, since there would be no winner to report.
+template <typename T>
+auto when_any(Scheduler& scheduler, std::vector<Task<T>> tasks) -> WhenAwaitable<WhenRange<true, T>> {
+    if (tasks.empty()) { throw std::invalid_argument("when_any needs at least one task"); }
+    return {scheduler, std::make_shared<WhenRange<true, T>>(std::move(tasks))};
+}
+
+} // namespace vial
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <coroutine>
+
+#include "io/io_awaitables.hh"
+
+namespace vial {
+
+//! Awaitable that puts the task back on the scheduler's queue, so the worker runs the tasks
+//! already waiting before resuming it.
+struct Yield {
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) noexcept {
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = new ResumeNow;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+//! Let other tasks run, e.g. between chunks of a long computation:
+//! `for (auto& chunk : chunks) { process(chunk); co_await vial::yield(); }`
+inline auto yield() -> Yield { return {}; }
+
+} // namespace vial
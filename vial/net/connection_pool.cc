@@ -0,0 +1,203 @@
+#include "connection_pool.hh"
+#include <poll.h>
+#include <algorithm>
+#include "../core/scheduler.hh"
+
+namespace vial::net {
+
+namespace {
+
+//! An idle connection is reusable if the peer hasn't closed it or sent anything unsolicited.
+auto is_idle_connection_alive(const Socket& socket) -> bool {
+    struct pollfd pfd = {socket.fd(), POLLIN, 0};
+    return poll(&pfd, 1, 0) == 0;
+}
+
+} // namespace
+
+//! Awaitable that suspends until a connection to the destination is released, unless one was
+//! released (or closed) after the `since` snapshot of `HostLimit::releases`.
+struct ConnectionPool::SlotWaiter : IOAwaitable {
+    HostLimit* limit;
+    size_t max_per_host;
+    uint64_t since;
+
+    SlotWaiter(HostLimit* host_limit, size_t max, uint64_t releases)
+        : limit(host_limit), max_per_host(max), since(releases) {}
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) noexcept {
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = this->clone();
+    }
+
+    void await_resume() noexcept {}
+
+    [[nodiscard]] auto clone() const -> IOAwaitable* override {
+        return new SlotWaiter(limit, max_per_host, since);
+    }
+
+    void register_with_event_loop(std::function<void()> callback) override {
+        {
+            std::lock_guard guard(limit->lock);
+
+            // A connection may have been released since the acquirer looked
+            if (limit->open >= max_per_host && limit->releases == since) {
+                limit->waiters.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+};
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool_(other.pool_), shard_(other.shard_), key_(other.key_),
+      socket_(std::move(other.socket_)), reusable_(other.reusable_) {
+    other.pool_ = nullptr;
+}
+
+auto PooledConnection::operator=(PooledConnection&& other) noexcept -> PooledConnection& {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        shard_ = other.shard_;
+        key_ = other.key_;
+        socket_ = std::move(other.socket_);
+        reusable_ = other.reusable_;
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+PooledConnection::~PooledConnection() {
+    release();
+}
+
+void PooledConnection::release() noexcept {
+    if (pool_ != nullptr) {
+        pool_->release(shard_, key_, std::move(socket_), reusable_);
+        pool_ = nullptr;
+    }
+}
+
+ConnectionPool::ConnectionPool(Options options) : options_(options) {
+    options_.num_shards = std::max<size_t>(options_.num_shards, 1);
+    options_.max_per_host = std::max<size_t>(options_.max_per_host, 1);
+
+    shards_.reserve(options_.num_shards);
+    for (size_t i = 0; i < options_.num_shards; i++) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+auto ConnectionPool::local_shard() const -> size_t {
+    if (auto worker = Scheduler::current_worker_id()) { return *worker % shards_.size(); }
+    return std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards_.size();
+}
+
+auto ConnectionPool::host_limit(size_t shard, uint64_t key) -> HostLimit& {
+    std::lock_guard guard(shards_[shard]->lock);
+    auto& entry = shards_[shard]->hosts[key];
+    if (entry.limit == nullptr) {
+        std::lock_guard limits_guard(limits_lock_);
+        entry.limit = &limits_[key];
+    }
+    return *entry.limit;
+}
+
+auto ConnectionPool::take_idle(size_t shard, uint64_t key, HostLimit& limit) -> Socket {
+    std::lock_guard guard(shards_[shard]->lock);
+    auto found = shards_[shard]->hosts.find(key);
+    if (found == shards_[shard]->hosts.end()) { return Socket{}; }
+
+    auto& idle = found->second.idle;
+    while (!idle.empty()) {
+        Socket socket = std::move(idle.back());
+        idle.pop_back();
+        if (is_idle_connection_alive(socket)) { return socket; }
+
+        std::lock_guard limit_guard(limit.lock);
+        limit.open--;
+    }
+    return Socket{};
+}
+
+auto ConnectionPool::acquire(const char* host, int port) -> Task<PooledConnection> {
+    auto addr = parse_address(host, port);
+    if (!addr) { co_return PooledConnection{nullptr, 0, 0, Socket::failed(EINVAL)}; }
+
+    const uint64_t key = (static_cast<uint64_t>(addr->sin_addr.s_addr) << 16U) | addr->sin_port;
+    const size_t shard = local_shard();
+    HostLimit& limit = host_limit(shard, key);
+
+    while (true) {
+        uint64_t since = 0;
+        {
+            std::lock_guard guard(limit.lock);
+            since = limit.releases;
+        }
+
+        if (Socket socket = take_idle(shard, key, limit); socket.is_valid()) {
+            co_return PooledConnection{this, shard, key, std::move(socket)};
+        }
+
+        // Reserve a slot for a new connection
+        {
+            std::lock_guard guard(limit.lock);
+            if (limit.open < options_.max_per_host) {
+                limit.open++;
+                break;
+            }
+        }
+
+        // At the cap: the idle connections may all sit in other sub-pools
+        for (size_t offset = 1; offset < shards_.size(); offset++) {
+            if (Socket socket = take_idle((shard + offset) % shards_.size(), key, limit); socket.is_valid()) {
+                co_return PooledConnection{this, shard, key, std::move(socket)};
+            }
+        }
+
+        co_await SlotWaiter{&limit, options_.max_per_host, since};
+    }
+
+    Socket socket = co_await connect(host, port);
+    if (!socket.is_valid()) {
+        release(shard, key, Socket{}, false);
+        co_return PooledConnection{nullptr, 0, 0, std::move(socket)};
+    }
+
+    co_return PooledConnection{this, shard, key, std::move(socket)};
+}
+
+void ConnectionPool::release(size_t shard, uint64_t key, Socket socket, bool reusable) {
+    HostLimit& limit = host_limit(shard, key);
+    bool kept = false;
+    {
+        std::lock_guard guard(shards_[shard]->lock);
+        auto& entry = shards_[shard]->hosts[key];
+        if (reusable && socket.is_valid() && entry.idle.size() < options_.max_idle_per_host) {
+            entry.idle.push_back(std::move(socket));
+            kept = true;
+        }
+    }
+
+    std::function<void()> waiter;
+    {
+        // After the connection is idle, so a waiter woken (or one that sees the bump) finds it
+        std::lock_guard guard(limit.lock);
+        if (!kept) { limit.open--; }
+        limit.releases++;
+
+        if (!limit.waiters.empty()) {
+            waiter = std::move(limit.waiters.front());
+            limit.waiters.pop_front();
+        }
+    }
+
+    if (waiter) { waiter(); }
+}
+
+} // namespace vial::net
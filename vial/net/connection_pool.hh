@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "socket.hh"
+
+namespace vial::net {
+
+class ConnectionPool;
+
+//! A connection leased from a ConnectionPool. Returned to the pool when destroyed.
+class PooledConnection {
+  public:
+    //! Default constructor - invalid connection
+    PooledConnection() = default;
+
+    PooledConnection(PooledConnection&& other) noexcept;
+    auto operator=(PooledConnection&& other) noexcept -> PooledConnection&;
+
+    PooledConnection(const PooledConnection&) = delete;
+    auto operator=(const PooledConnection&) -> PooledConnection& = delete;
+
+    //! Destructor returns the connection to its pool
+    ~PooledConnection();
+
+    //! Get the leased socket
+    [[nodiscard]] auto socket() noexcept -> Socket& { return socket_; }
+
+    //! Check if the lease holds a connected socket
+    [[nodiscard]] auto is_valid() const noexcept -> bool { return socket_.is_valid(); }
+
+    //! Close the connection instead of returning it to the pool (e.g. after a protocol error)
+    void discard() noexcept { reusable_ = false; }
+
+  private:
+    friend ConnectionPool;
+
+    PooledConnection(ConnectionPool* pool, size_t shard, uint64_t key, Socket socket)
+        : pool_(pool), shard_(shard), key_(key), socket_(std::move(socket)) {}
+
+    void release() noexcept;
+
+    ConnectionPool* pool_ = nullptr;
+    size_t shard_ = 0;
+    uint64_t key_ = 0;
+    Socket socket_;
+    bool reusable_ = true;
+};
+
+//! Per-destination pool of outbound TCP connections.
+//! Idle connections are sharded into sub-pools by worker thread so reusing one only touches a
+//! lock no other worker contends on. The cap on open connections is per destination across all
+//! sub-pools; at the cap an acquirer takes an idle connection from another sub-pool before waiting.
+//! The pool must outlive every PooledConnection it hands out.
+class ConnectionPool {
+  public:
+    struct Options {
+        //! Maximum open (idle + leased) connections per destination, over all sub-pools.
+        size_t max_per_host = 64;
+
+        //! Maximum idle connections kept per destination in each sub-pool.
+        size_t max_idle_per_host = 16;
+
+        //! Number of sub-pools.
+        size_t num_shards = std::thread::hardware_concurrency();
+    };
+
+    ConnectionPool() : ConnectionPool(Options{}) {}
+    explicit ConnectionPool(Options options);
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool(ConnectionPool&&) = delete;
+    auto operator=(const ConnectionPool&) -> ConnectionPool& = delete;
+    auto operator=(ConnectionPool&&) -> ConnectionPool& = delete;
+    ~ConnectionPool() = default;
+
+    //! Lease a connection to host:port, reusing an idle one if possible.
+    //! Suspends while the destination is at `max_per_host`.
+    //! Returns an invalid PooledConnection if connecting fails, whose `socket().error()` says why.
+    [[nodiscard]] auto acquire(const char* host, int port) -> Task<PooledConnection>;
+
+  private:
+    friend PooledConnection;
+    struct SlotWaiter;
+
+    //! Connections to one destination, shared by every sub-pool.
+    struct HostLimit {
+        std::mutex lock;
+
+        // Idle + leased connections
+        size_t open = 0;
+
+        // Bumped on every release, so an acquirer can tell a connection was returned while it
+        // was looking through the sub-pools
+        uint64_t releases = 0;
+
+        // Wakeups for acquirers suspended on `max_per_host`
+        std::deque<std::function<void()>> waiters;
+    };
+
+    struct Host {
+        // Idle connections, most recently used at the back
+        std::vector<Socket> idle;
+
+        // Entry in `limits_`, cached so acquires don't take `limits_lock_`
+        HostLimit* limit = nullptr;
+    };
+
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<uint64_t, Host> hosts;
+    };
+
+    //! Sub-pool for the calling worker thread
+    [[nodiscard]] auto local_shard() const -> size_t;
+
+    //! Shared limit of the destination `key`, looked up through `shard`.
+    auto host_limit(size_t shard, uint64_t key) -> HostLimit&;
+
+    //! Take a live idle connection to `key` from `shard`, closing dead ones on the way.
+    auto take_idle(size_t shard, uint64_t key, HostLimit& limit) -> Socket;
+
+    //! Return a leased connection to the shard it was acquired from
+    void release(size_t shard, uint64_t key, Socket socket, bool reusable);
+
+    Options options_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    // Node-based, so entries stay put as destinations are added
+    std::mutex limits_lock_;
+    std::unordered_map<uint64_t, HostLimit> limits_;
+};
+
+} // namespace vial::net
@@ -0,0 +1,117 @@
+#include "idle_reaper.hh"
+#include <algorithm>
+#include <array>
+#include <sys/socket.h>
+#include "../core/sleep.hh"
+
+namespace vial::net {
+
+struct IdleReaper::Ring {
+    TimerClock::duration granularity;
+
+    //! Sweeps done so far
+    std::atomic<uint32_t> tick = 0;
+    std::atomic<bool> stopped = false;
+
+    mutable std::mutex lock;
+    std::array<std::vector<std::shared_ptr<IdleEntry>>, kIdleReaperBuckets> buckets;
+    size_t size = 0;
+
+    //! Sweep the bucket due at the current tick
+    void sweep();
+};
+
+IdleReaper::IdleReaper(std::chrono::milliseconds timeout) : ring_(std::make_shared<Ring>()) {
+    ring_->granularity = std::max(TimerClock::duration(timeout) / kIdleReaperBuckets, kTimerTick);
+}
+
+IdleReaper::~IdleReaper() {
+    stop();
+}
+
+void IdleReaper::watch(Socket& socket) {
+    if (!socket.is_valid() || ring_->stopped) { return; }
+
+    auto entry = std::make_shared<IdleEntry>();
+    entry->fd = socket.fd();
+    entry->clock = &ring_->tick;
+    entry->owner = ring_;
+
+    std::lock_guard guard(ring_->lock);
+    uint32_t now = ring_->tick.load();
+    entry->last_active = now;
+
+    // First looked at one tick from now, then re-bucketed by its expiry
+    ring_->buckets.at((now + 1) % kIdleReaperBuckets).push_back(entry);
+    ring_->size++;
+
+    socket.set_idle_entry(std::move(entry));
+}
+
+auto IdleReaper::run() -> Task<void> {
+    return sweep_loop(ring_);
+}
+
+void IdleReaper::stop() {
+    ring_->stopped = true;
+
+    // Entries hold the ring alive, so drop them to break the cycle
+    std::lock_guard guard(ring_->lock);
+    for (auto& bucket : ring_->buckets) { bucket.clear(); }
+    ring_->size = 0;
+}
+
+auto IdleReaper::size() const -> size_t {
+    std::lock_guard guard(ring_->lock);
+    return ring_->size;
+}
+
+auto IdleReaper::sweep_loop(std::shared_ptr<Ring> ring) -> Task<void> {
+    // Sleep to absolute deadlines so the ticks don't drift by the wakeup latency
+    auto next = TimerClock::now();
+    while (!ring->stopped) {
+        next += ring->granularity;
+        if (co_await sleep_until(next) == WaitStatus::kCancelled || ring->stopped) { break; }
+
+        ring->tick.fetch_add(1);
+        ring->sweep();
+    }
+    co_return;
+}
+
+void IdleReaper::Ring::sweep() {
+    uint32_t now = tick.load();
+    std::vector<std::shared_ptr<IdleEntry>> due;
+    {
+        std::lock_guard guard(lock);
+        due.swap(buckets.at(now % kIdleReaperBuckets));
+    }
+
+    size_t dropped = 0;
+    std::vector<std::shared_ptr<IdleEntry>> survivors;
+    for (auto& entry : due) {
+        // One extra tick since the last activity may have been late in its tick
+        uint32_t expiry = entry->last_active.load(std::memory_order_relaxed) + kIdleReaperBuckets + 1;
+
+        std::lock_guard guard(entry->lock);
+        if (entry->fd < 0) {
+            dropped++;
+        } else if (static_cast<int32_t>(expiry - now) <= 0) {
+            ::shutdown(entry->fd, SHUT_RDWR);
+            entry->fd = -1;
+            dropped++;
+        } else {
+            survivors.push_back(std::move(entry));
+        }
+    }
+
+    std::lock_guard guard(lock);
+    if (stopped) { return; }
+    for (auto& entry : survivors) {
+        uint32_t expiry = entry->last_active.load(std::memory_order_relaxed) + kIdleReaperBuckets + 1;
+        buckets.at(expiry % kIdleReaperBuckets).push_back(std::move(entry));
+    }
+    size -= dropped;
+}
+
+} // namespace vial::net
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "socket.hh"
+
+namespace vial::net {
+
+//! Buckets in the IdleReaper ring. The idle timeout is split into this many sweeps, so a
+//! connection is shut down between `timeout` and `timeout * (1 + 2/kIdleReaperBuckets)` after
+//! its last traffic.
+constexpr uint32_t kIdleReaperBuckets = 16;
+
+//! Per-socket idle tracking state, shared between a watched Socket and its IdleReaper.
+struct IdleEntry {
+    //! Reaper tick of the last read or write
+    std::atomic<uint32_t> last_active = 0;
+
+    //! The reaper's tick counter (kept alive by `owner`)
+    const std::atomic<uint32_t>* clock = nullptr;
+    std::shared_ptr<void> owner;
+
+    //! Guards `fd` so the reaper never shuts down an fd the socket has closed (and maybe reused)
+    std::mutex lock;
+    int fd = -1;
+
+    //! Record traffic - a relaxed load and store, no timer is touched.
+    void touch() noexcept { last_active.store(clock->load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+    //! The socket is closing; the reaper drops the entry on its next sweep.
+    void detach() noexcept {
+        std::lock_guard guard(lock);
+        fd = -1;
+    }
+};
+
+//! Shuts down watched sockets that have seen no reads or writes for a timeout.
+//! Connections are kept in a ring of coarse buckets swept by a single periodic timer, so a read
+//! or write only stamps the current tick and hundreds of thousands of keepalive connections
+//! cost one timer in total. Idle sockets are shut down (not closed): pending and later reads see
+//! EOF and the owner closes the socket as usual.
+class IdleReaper {
+  public:
+    explicit IdleReaper(std::chrono::milliseconds timeout);
+
+    IdleReaper(const IdleReaper&) = delete;
+    IdleReaper(IdleReaper&&) = delete;
+    auto operator=(const IdleReaper&) -> IdleReaper& = delete;
+    auto operator=(IdleReaper&&) -> IdleReaper& = delete;
+
+    //! Stops the reaper; watched sockets are no longer timed out.
+    ~IdleReaper();
+
+    //! Start timing out `socket` (e.g. right after `accept`).
+    void watch(Socket& socket);
+
+    //! Sweep loop - fire_and_forget this on the Scheduler. Ends after `stop`.
+    [[nodiscard]] auto run() -> Task<void>;
+
+    //! Stop sweeping and forget every watched socket.
+    void stop();
+
+    //! Number of sockets currently watched (including closed ones not swept yet).
+    [[nodiscard]] auto size() const -> size_t;
+
+  private:
+    //! State shared with the sweep loop and every IdleEntry
+    struct Ring;
+
+    static auto sweep_loop(std::shared_ptr<Ring> ring) -> Task<void>;
+
+    std::shared_ptr<Ring> ring_;
+};
+
+} // namespace vial::net
@@ -3,22 +3,600 @@
 #include <fcntl.h>
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <linux/errqueue.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include "../core/deadline.hh"
+#include "../core/yield.hh"
+#include "idle_reaper.hh"
 
 namespace vial::net {
 
+namespace {
+
+//! Readiness reported by the event loop can be stale by the time the task resumes.
+auto would_block(ssize_t ret) -> bool {
+    return ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+//! errno reported when a wait gave up before the socket was ready.
+auto wait_errno(WaitStatus status) -> int {
+    return status == WaitStatus::kTimedOut ? ETIMEDOUT : ECANCELED;
+}
+
+//! Syscall result with a failure turned into a negative errno, which (unlike errno itself)
+//! survives the awaiting task resuming on another worker.
+auto in_band(ssize_t ret) -> ssize_t {
+    return ret < 0 ? -errno : ret;
+}
+
+//! Connect a new socket of `domain` to `addr` - suspends until the connection is established.
+//! `addr` must stay alive until the returned task completes.
+auto connect_to(int domain, const struct sockaddr* addr, socklen_t addr_len) -> Task<Socket> {
+    int fd = socket(domain, SOCK_STREAM, 0);
+    if (fd < 0) {
+        int error = errno;
+        std::cerr << "Failed to create socket: " << strerror(error) << std::endl;
+        co_return Socket::failed(error);
+    }
+
+    // Made non-blocking and registered with the event loop before connecting
+    Socket sock{fd};
+    uint32_t seq = IOEventLoop::instance().write_sequence(fd);
+
+    if (::connect(fd, addr, addr_len) < 0) {
+        if (errno != EINPROGRESS) {
+            co_return Socket::failed(errno);
+        }
+
+        // Writable once the handshake completes (or fails)
+        if (auto status = co_await WaitForWrite{fd, seq}; status != WaitStatus::kReady) {
+            co_return Socket::failed(wait_errno(status));
+        }
+
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0) {
+            co_return Socket::failed(errno);
+        }
+        if (error != 0) {
+            co_return Socket::failed(error);
+        }
+    }
+
+    co_return sock;
+}
+
+auto make_unix_address(const char* path) -> std::optional<sockaddr_un> {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+
+    if (path == nullptr || strlen(path) >= sizeof(addr.sun_path)) {
+        return std::nullopt;
+    }
+
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+//! Remove the socket file at `addr` if a previous process left it behind. Fails with errno
+//! EADDRINUSE if the path is something else, or a socket someone is still listening on.
+auto remove_stale_unix_socket(const sockaddr_un& addr) -> bool {
+    struct stat info{};
+    if (lstat(addr.sun_path, &info) < 0) { return errno == ENOENT; }
+
+    if (!S_ISSOCK(info.st_mode)) {
+        errno = EADDRINUSE;
+        return false;
+    }
+
+    // Only a socket without a listener refuses connections. Non-blocking, so a live listener
+    // with a full backlog (EAGAIN) can't stall the worker, and counts as live like any other error
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (probe < 0) { return false; }
+    int ret = ::connect(probe, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)); // NOLINT
+    bool stale = ret < 0 && errno == ECONNREFUSED;
+    ::close(probe);
+
+    if (!stale) {
+        errno = EADDRINUSE;
+        return false;
+    }
+    return ::unlink(addr.sun_path) == 0 || errno == ENOENT;
+}
+
+} // namespace
+
+//! Receives completed by the event loop on behalf of a socket in multishot mode.
+struct Socket::RecvRing {
+    std::mutex lock;
+
+    // Completed receives, oldest first
+    std::deque<Buffer> completed;
+
+    // Bytes of `completed.front()` already consumed by a partial `read(span)`
+    size_t front_offset = 0;
+
+    // EOF or an error was hit; no further completions will arrive
+    bool closed = false;
+    int error = 0;
+
+    // Wakeup for a reader suspended on an empty ring
+    std::function<void()> waiter;
+
+    // The event loop stopped reading the socket because the ring was full
+    bool paused = false;
+
+    size_t buffer_size = kDefaultReadSize;
+
+    //! Called by the reader after consuming, with `lock` held. Returns true if reads were paused
+    //! and the ring has drained to half, so the reader must resume them.
+    auto take_resume() -> bool {
+        if (!paused || completed.size() > kRecvRingSize / 2) { return false; }
+        paused = false;
+        return true;
+    }
+};
+
+//! Awaitable that suspends until the ring has a completion or is closed.
+struct Socket::WaitForRecv : IOAwaitable {
+    std::shared_ptr<RecvRing> ring;
+
+    //! Set by `await_ready` when the ring was ready but the task has to yield first
+    bool out_of_budget = false;
+
+    explicit WaitForRecv(std::shared_ptr<RecvRing> recv_ring) : ring(std::move(recv_ring)) {}
+
+    [[nodiscard]] auto await_ready() noexcept -> bool {
+        bool ready = false;
+        {
+            std::lock_guard guard(ring->lock);
+            ready = !ring->completed.empty() || ring->closed;
+        }
+        return spend_budget(ready, out_of_budget);
+    }
+
+    template <typename S>
+    void await_suspend(std::coroutine_handle<S> handle) noexcept {
+        handle.promise().set_state(TaskState::kBlockedOnIO);
+        handle.promise().get_io_awaitable() = out_of_budget ? new ResumeNow : this->clone();
+    }
+
+    void await_resume() noexcept {}
+
+    [[nodiscard]] auto clone() const -> IOAwaitable* override {
+        return new WaitForRecv(ring);
+    }
+
+    void register_with_event_loop(std::function<void()> callback) override {
+        {
+            std::lock_guard guard(ring->lock);
+            if (ring->completed.empty() && !ring->closed) {
+                ring->waiter = std::move(callback);
+                return;
+            }
+        }
+        callback();
+    }
+
+    auto cancel() -> bool override {
+        std::function<void()> removed;
+        {
+            std::lock_guard guard(ring->lock);
+            removed = std::exchange(ring->waiter, nullptr);
+        }
+        return static_cast<bool>(removed);
+    }
+};
+
+void Socket::enable_multishot_recv(size_t buffer_size) {
+    if (fd_ < 0 || recv_ring_ != nullptr) { return; }
+
+    recv_ring_ = std::make_shared<RecvRing>();
+    recv_ring_->buffer_size = buffer_size;
+
+    // The callback shares ownership so the ring outlives any in-flight dispatch, which may still
+    // be running after close() (see there)
+    IOEventLoop::instance().register_multishot_read_callback(fd_, [fd = fd_, ring = recv_ring_]() {
+        fill_recv_ring(fd, *ring);
+    });
+}
+
+void Socket::fill_recv_ring(int fd, RecvRing& ring) {
+    std::function<void()> waiter;
+    {
+        std::lock_guard guard(ring.lock);
+
+        // Leave data in the socket once the ring is full, the reader resumes reads as it drains
+        while (!ring.closed && ring.completed.size() < kRecvRingSize) {
+            Buffer buffer = BufferPool::instance().lease(ring.buffer_size);
+            ssize_t ret = ::read(fd, buffer.data(), std::min(ring.buffer_size, buffer.capacity()));
+
+            if (ret > 0) {
+                buffer.resize(static_cast<size_t>(ret));
+                ring.completed.push_back(std::move(buffer));
+                continue;
+            }
+            if (would_block(ret)) { break; }
+
+            ring.closed = true;
+            ring.error = ret < 0 ? errno : 0;
+        }
+
+        // Even if already paused: a reader resuming concurrently may have re-armed it
+        if (!ring.closed && ring.completed.size() >= kRecvRingSize) {
+            ring.paused = true;
+            IOEventLoop::instance().pause_reads(fd);
+        }
+
+        if (ring.waiter && (!ring.completed.empty() || ring.closed)) {
+            waiter = std::move(ring.waiter);
+            ring.waiter = nullptr;
+        }
+    }
+
+    if (waiter) { waiter(); }
+}
+
 auto Socket::read(std::span<std::byte> buffer) const -> Task<ssize_t> {
-    co_await WaitForRead{fd_};
-    co_return ::read(fd_, buffer.data(), buffer.size());
+    return read_until(buffer, std::nullopt);
+}
+
+auto Socket::read(std::span<std::byte> buffer, TimerClock::time_point deadline) const -> Task<ssize_t> {
+    return read_until(buffer, deadline);
+}
+
+auto Socket::read_until(std::span<std::byte> buffer, std::optional<TimerClock::time_point> deadline) const -> Task<ssize_t> {
+    if (recv_ring_ != nullptr) {
+        auto ring = recv_ring_;
+        if (auto status = co_await with_deadline<WaitForRecv>(deadline, ring); status != WaitStatus::kReady) {
+            co_return -wait_errno(status);
+        }
+
+        size_t copied = 0;
+        bool resume = false;
+        {
+            std::lock_guard guard(ring->lock);
+            if (ring->completed.empty()) { co_return -ring->error; }
+
+            while (copied < buffer.size() && !ring->completed.empty()) {
+                auto& front = ring->completed.front();
+                size_t count = std::min(buffer.size() - copied, front.size() - ring->front_offset);
+                std::memcpy(buffer.data() + copied, front.data() + ring->front_offset, count);
+                copied += count;
+                ring->front_offset += count;
+
+                if (ring->front_offset == front.size()) {
+                    ring->completed.pop_front();
+                    ring->front_offset = 0;
+                }
+            }
+            resume = ring->take_resume();
+        }
+
+        if (resume) { IOEventLoop::instance().resume_reads(fd_); }
+        mark_active();
+        co_return static_cast<ssize_t>(copied);
+    }
+
+    while (true) {
+        uint32_t seq = IOEventLoop::instance().read_sequence(fd_);
+        ssize_t ret = ::read(fd_, buffer.data(), buffer.size());
+        if (!would_block(ret)) {
+            ret = in_band(ret);
+            if (ret > 0) { mark_active(); }
+            // Completing without a wait spends the task's budget, so an always ready peer
+            // can't hold the worker
+            if (!CoopBudget::consume()) { co_await yield(); }
+            co_return ret;
+        }
+        if (auto status = co_await with_deadline<WaitForRead>(deadline, fd_, seq); status != WaitStatus::kReady) {
+            co_return -wait_errno(status);
+        }
+    }
+}
+
+auto Socket::read(size_t max_bytes) const -> Task<Buffer> {
+    if (recv_ring_ != nullptr) {
+        auto ring = recv_ring_;
+        if (auto status = co_await with_deadline<WaitForRecv>(std::nullopt, ring); status != WaitStatus::kReady) {
+            co_return Buffer::failed(wait_errno(status));
+        }
+
+        Buffer buffer;
+        bool resume = false;
+        {
+            std::lock_guard guard(ring->lock);
+            if (ring->completed.empty()) { co_return Buffer::failed(ring->error); }
+
+            buffer = std::move(ring->completed.front());
+            ring->completed.pop_front();
+            resume = ring->take_resume();
+
+            // Drop the prefix a partial `read(span)` already consumed
+            if (ring->front_offset > 0) {
+                size_t remaining = buffer.size() - ring->front_offset;
+                std::memmove(buffer.data(), buffer.data() + ring->front_offset, remaining);
+                buffer.resize(remaining);
+                ring->front_offset = 0;
+            }
+        }
+
+        if (resume) { IOEventLoop::instance().resume_reads(fd_); }
+        mark_active();
+        co_return buffer;
+    }
+
+    while (true) {
+        uint32_t seq = IOEventLoop::instance().read_sequence(fd_);
+
+        Buffer buffer = BufferPool::instance().lease(max_bytes);
+        ssize_t ret = ::read(fd_, buffer.data(), std::min(max_bytes, buffer.capacity()));
+        if (would_block(ret)) {
+            // Don't hold a buffer while parked
+            buffer = Buffer{};
+            if (auto status = co_await WaitForRead{fd_, seq}; status != WaitStatus::kReady) {
+                co_return Buffer::failed(wait_errno(status));
+            }
+            continue;
+        }
+
+        if (ret <= 0) { co_return Buffer::failed(ret < 0 ? errno : 0); }
+
+        buffer.resize(static_cast<size_t>(ret));
+        mark_active();
+        if (!CoopBudget::consume()) { co_await yield(); }
+        co_return buffer;
+    }
 }
 
 auto Socket::write(std::span<const std::byte> data) const -> Task<ssize_t> {
-    co_await WaitForWrite{fd_};
-    co_return ::write(fd_, data.data(), data.size());
+    return write_until(data, std::nullopt);
+}
+
+auto Socket::write(std::span<const std::byte> data, TimerClock::time_point deadline) const -> Task<ssize_t> {
+    return write_until(data, deadline);
+}
+
+auto Socket::write_until(std::span<const std::byte> data, std::optional<TimerClock::time_point> deadline) const -> Task<ssize_t> {
+    while (true) {
+        uint32_t seq = IOEventLoop::instance().write_sequence(fd_);
+        ssize_t ret = ::write(fd_, data.data(), data.size());
+        if (!would_block(ret)) {
+            ret = in_band(ret);
+            if (ret > 0) { mark_active(); }
+            if (!CoopBudget::consume()) { co_await yield(); }
+            co_return ret;
+        }
+        if (auto status = co_await with_deadline<WaitForWrite>(deadline, fd_, seq); status != WaitStatus::kReady) {
+            co_return -wait_errno(status);
+        }
+    }
+}
+
+auto Socket::send_zerocopy(std::span<const std::byte> data) -> Task<ssize_t> {
+    if (data.size() < kZerocopyThreshold || zerocopy_copied_) {
+        co_return co_await write(data);
+    }
+
+    if (!zerocopy_enabled_) {
+        int opt = 1;
+        if (setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &opt, sizeof(opt)) < 0) {
+            // Socket type or kernel without zerocopy support
+            co_return co_await write(data);
+        }
+        zerocopy_enabled_ = true;
+    }
+
+    size_t sent = 0;
+    int send_errno = 0;
+
+    while (sent < data.size()) {
+        uint32_t seq = IOEventLoop::instance().write_sequence(fd_);
+        ssize_t ret = ::send(fd_, data.data() + sent, data.size() - sent, MSG_ZEROCOPY | MSG_NOSIGNAL);
+        if (ret < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (auto status = co_await WaitForWrite{fd_, seq}; status != WaitStatus::kReady) {
+                    send_errno = wait_errno(status);
+                    break;
+                }
+                continue;
+            }
+            send_errno = errno;
+            break;
+        }
+
+        // Every successful MSG_ZEROCOPY send produces exactly one completion id
+        zerocopy_pending_++;
+        sent += static_cast<size_t>(ret);
+    }
+
+    // The kernel may still reference the buffer until every completion is reaped
+    reap_zerocopy_completions();
+    while (zerocopy_pending_ > 0) {
+        co_await WaitForError{fd_};
+
+        // A hard error (e.g. ECONNRESET) also wakes the wait, and the remaining completions
+        // may never come: the kernel releases the buffer as it tears the connection down.
+        // POLLERR with nothing on the error queue means the socket has a pending error, which is
+        // left in place (unlike reading SO_ERROR) for the socket's next call to report.
+        pollfd poll_fd{fd_, 0, 0};
+        bool has_error = ::poll(&poll_fd, 1, 0) == 1 && (poll_fd.revents & POLLERR) != 0;
+        if (reap_zerocopy_completions() == 0 && has_error) { zerocopy_pending_ = 0; }
+    }
+
+    if (sent == 0 && send_errno != 0) { co_return -send_errno; }
+    mark_active();
+    co_return static_cast<ssize_t>(sent);
+}
+
+void Socket::close() noexcept {
+    if (idle_ != nullptr) {
+        // Before the fd can be reused
+        idle_->detach();
+        idle_.reset();
+    }
+
+    if (recv_ring_ != nullptr) {
+        // Waits out a fill in progress on the loop thread, and keeps later ones (still running
+        // after unregister_fd) off the fd number, which may be reused once it is closed
+        std::lock_guard guard(recv_ring_->lock);
+        recv_ring_->closed = true;
+    }
+
+    if (fd_ >= 0) {
+        IOEventLoop::instance().unregister_fd(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    recv_ring_.reset();
+}
+
+void Socket::set_idle_entry(std::shared_ptr<IdleEntry> entry) noexcept {
+    if (idle_ != nullptr) { idle_->detach(); }
+    idle_ = std::move(entry);
+}
+
+void Socket::mark_active() const noexcept {
+    if (idle_ != nullptr) { idle_->touch(); }
+}
+
+auto Socket::reap_zerocopy_completions() noexcept -> size_t {
+    size_t count = 0;
+    while (zerocopy_pending_ > 0) {
+        std::array<char, CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))> control{};
+        msghdr msg{};
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+
+        if (recvmsg(fd_, &msg, MSG_ERRQUEUE) < 0) {
+            // EAGAIN: error queue drained
+            return count;
+        }
+        count++;
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            bool is_recverr = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                              (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!is_recverr) { continue; }
+
+            const auto* err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg)); // NOLINT
+            if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY || err->ee_errno != 0) { continue; }
+
+            // Notifications cover the inclusive range of completion ids [ee_info, ee_data]
+            zerocopy_pending_ -= err->ee_data - err->ee_info + 1;
+            if ((err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0) {
+                zerocopy_copied_ = true;
+            }
+        }
+    }
+    return count;
+}
+
+auto Socket::send_fd(int fd) const -> Task<ssize_t> {
+    // Stream sockets need at least one byte of payload to carry ancillary data
+    std::byte payload{0};
+    iovec iov{&payload, sizeof(payload)};
+
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    while (true) {
+        uint32_t seq = IOEventLoop::instance().write_sequence(fd_);
+        ssize_t ret = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+        if (!would_block(ret)) { co_return in_band(ret); }
+        if (auto status = co_await WaitForWrite{fd_, seq}; status != WaitStatus::kReady) {
+            co_return -wait_errno(status);
+        }
+    }
+}
+
+auto Socket::recv_fd() const -> Task<int> {
+    std::byte payload{0};
+    iovec iov{&payload, sizeof(payload)};
+
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t ret = -1;
+    while (true) {
+        uint32_t seq = IOEventLoop::instance().read_sequence(fd_);
+        ret = ::recvmsg(fd_, &msg, MSG_CMSG_CLOEXEC);
+        if (!would_block(ret)) { break; }
+        if (auto status = co_await WaitForRead{fd_, seq}; status != WaitStatus::kReady) {
+            co_return -wait_errno(status);
+        }
+    }
+
+    if (ret < 0) { co_return -errno; }
+    if (ret == 0) { co_return -ECONNRESET; }
+
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            int received = -1;
+            std::memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+            co_return received;
+        }
+    }
+
+    co_return -EBADMSG;
 }
 
 auto Socket::accept() const -> Task<Socket> {
-    co_await WaitForRead{fd_};
-    co_return Socket{::accept(fd_, nullptr, nullptr)};
+    return accept_until(std::nullopt);
+}
+
+auto Socket::accept(TimerClock::time_point deadline) const -> Task<Socket> {
+    return accept_until(deadline);
+}
+
+auto Socket::accept_until(std::optional<TimerClock::time_point> deadline) const -> Task<Socket> {
+    while (true) {
+        uint32_t seq = IOEventLoop::instance().read_sequence(fd_);
+        int client_fd = ::accept(fd_, nullptr, nullptr);
+        if (client_fd >= 0) {
+            if (!CoopBudget::consume()) { co_await yield(); }
+            co_return Socket{client_fd};
+        }
+        if (!would_block(client_fd)) { co_return Socket::failed(errno); }
+        if (auto status = co_await with_deadline<WaitForRead>(deadline, fd_, seq); status != WaitStatus::kReady) {
+            co_return Socket::failed(wait_errno(status));
+        }
+    }
+}
+
+auto parse_address(const char* host, int port) -> std::optional<sockaddr_in> {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    
+    if (host == nullptr || strcmp(host, "0.0.0.0") == 0) {
+        addr.sin_addr.s_addr = INADDR_ANY;
+    } else if (inet_aton(host, &addr.sin_addr) == 0) {
+        return std::nullopt;
+    }
+    
+    return addr;
 }
 
 auto listen(const char* host, int port) -> Socket {
@@ -38,21 +616,14 @@ auto listen(const char* host, int port) -> Socket {
     }
     
     // Bind to address
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    
-    if (host == nullptr || strcmp(host, "0.0.0.0") == 0) {
-        addr.sin_addr.s_addr = INADDR_ANY;
-    } else {
-        if (inet_aton(host, &addr.sin_addr) == 0) {
-            std::cerr << "Invalid host address: " << host << std::endl;
-            ::close(server_fd);
-            return Socket{-1};
-        }
+    auto addr = parse_address(host, port);
+    if (!addr) {
+        std::cerr << "Invalid host address: " << host << std::endl;
+        ::close(server_fd);
+        return Socket{-1};
     }
     
-    if (bind(server_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) { // NOLINT
+    if (bind(server_fd, reinterpret_cast<struct sockaddr*>(&*addr), sizeof(*addr)) < 0) { // NOLINT
         std::cerr << "Failed to bind socket to " << host << ":" << port << " - " << strerror(errno) << std::endl;
         ::close(server_fd);
         return Socket{-1};
@@ -69,4 +640,71 @@ auto listen(const char* host, int port) -> Socket {
     return Socket{server_fd};
 }
 
-} // namespace vial::net
\ No newline at end of file
+auto connect(const char* host, int port) -> Task<Socket> {
+    auto addr = parse_address(host, port);
+    if (!addr) {
+        std::cerr << "Invalid host address: " << host << std::endl;
+        co_return Socket::failed(EINVAL);
+    }
+
+    co_return co_await connect_to(AF_INET, reinterpret_cast<struct sockaddr*>(&*addr), sizeof(*addr)); // NOLINT
+}
+
+auto listen_unix(const char* path) -> Socket {
+    auto addr = make_unix_address(path);
+    if (!addr) {
+        std::cerr << "Invalid unix socket path: " << path << std::endl;
+        return Socket{-1};
+    }
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd < 0) {
+        std::cerr << "Failed to create socket: " << strerror(errno) << std::endl;
+        return Socket{-1};
+    }
+
+    if (!remove_stale_unix_socket(*addr)) {
+        int error = errno;
+        std::cerr << "Failed to bind socket to " << path << " - " << strerror(error) << std::endl;
+        ::close(server_fd);
+        errno = error;
+        return Socket::failed(error);
+    }
+
+    if (bind(server_fd, reinterpret_cast<struct sockaddr*>(&*addr), sizeof(*addr)) < 0) { // NOLINT
+        std::cerr << "Failed to bind socket to " << path << " - " << strerror(errno) << std::endl;
+        ::close(server_fd);
+        return Socket{-1};
+    }
+
+    const int backlog = 10;
+    if (::listen(server_fd, backlog) < 0) {
+        std::cerr << "Failed to listen on socket: " << strerror(errno) << std::endl;
+        ::close(server_fd);
+        return Socket{-1};
+    }
+
+    return Socket{server_fd};
+}
+
+auto connect_unix(const char* path) -> Task<Socket> {
+    auto addr = make_unix_address(path);
+    if (!addr) {
+        std::cerr << "Invalid unix socket path: " << path << std::endl;
+        co_return Socket::failed(EINVAL);
+    }
+
+    co_return co_await connect_to(AF_UNIX, reinterpret_cast<struct sockaddr*>(&*addr), sizeof(*addr)); // NOLINT
+}
+
+auto socketpair() -> std::pair<Socket, Socket> {
+    std::array<int, 2> fds{-1, -1};
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) < 0) {
+        std::cerr << "Failed to create socket pair: " << strerror(errno) << std::endl;
+        return {Socket{-1}, Socket{-1}};
+    }
+
+    return {Socket{fds[0]}, Socket{fds[1]}};
+}
+
+} // namespace vial::net
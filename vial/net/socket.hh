@@ -2,17 +2,38 @@
 
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <span>
+#include <optional>
+#include <memory>
+#include <utility>
 #include "../core/task.hh"
+#include "../core/buffer_pool.hh"
+#include "../core/timer_wheel.hh"
 #include "../core/io/io_awaitables.hh"
 #include "../core/io/io_event_loop.hh"
 
 namespace vial::net {
 
-//! Socket wrapper providing Go-like blocking semantics with coroutines
+struct IdleEntry;
+
+//! Default upper bound for reads into a leased buffer.
+constexpr size_t kDefaultReadSize = 4096;
+
+//! Completed receives queued per socket in multishot mode before the event loop stops reading.
+constexpr size_t kRecvRingSize = 64;
+
+//! Writes smaller than this are cheaper to copy than to pin, so `send_zerocopy` falls back to `write`.
+constexpr size_t kZerocopyThreshold = 16 * 1024;
+
+//! Socket wrapper providing Go-like blocking semantics with coroutines.
+//! Operations report failures in-band, never through errno: the awaiting task may resume on
+//! another worker, whose errno is unrelated. Byte counts are a negative errno on failure (e.g.
+//! -ETIMEDOUT), and Sockets and Buffers carry it in `error()`. A pending operation gives up with
+//! ECANCELED when the task's cancellation token fires.
 class Socket {
   public:
     //! Default constructor - invalid socket
@@ -31,7 +52,14 @@ class Socket {
     }
     
     //! Move constructor
-    Socket(Socket&& other) noexcept : fd_(other.fd_) {
+    Socket(Socket&& other) noexcept
+        : fd_(other.fd_),
+          zerocopy_enabled_(other.zerocopy_enabled_),
+          zerocopy_copied_(other.zerocopy_copied_),
+          zerocopy_pending_(other.zerocopy_pending_),
+          error_(other.error_),
+          recv_ring_(std::move(other.recv_ring_)),
+          idle_(std::move(other.idle_)) {
         other.fd_ = -1;
     }
     
@@ -40,6 +68,12 @@ class Socket {
         if (this != &other) {
             close();
             fd_ = other.fd_;
+            zerocopy_enabled_ = other.zerocopy_enabled_;
+            zerocopy_copied_ = other.zerocopy_copied_;
+            zerocopy_pending_ = other.zerocopy_pending_;
+            error_ = other.error_;
+            recv_ring_ = std::move(other.recv_ring_);
+            idle_ = std::move(other.idle_);
             other.fd_ = -1;
         }
         return *this;
@@ -51,21 +85,70 @@ class Socket {
     
     //! Destructor closes socket
     ~Socket() { 
-        if (fd_ >= 0) {
-            IOEventLoop::instance().unregister_fd(fd_);
-        }
         close();
     }
     
-    //! Read data from socket - suspends if no data available
+    //! Invalid socket recording why the operation that should have produced one failed.
+    [[nodiscard]] static auto failed(int error) -> Socket {
+        Socket socket;
+        socket.error_ = error;
+        return socket;
+    }
+    
+    //! Read data from socket - suspends if no data available.
+    //! Returns the bytes read, 0 on EOF, or a negative errno.
     [[nodiscard]] auto read(std::span<std::byte> buffer) const -> Task<ssize_t>;
     
-    //! Write data to socket - suspends if write would block
+    //! Read data from socket, giving up at `deadline` - returns -ETIMEDOUT if no data arrived
+    //! in time. The pending readiness wait is withdrawn from the event loop.
+    [[nodiscard]] auto read(std::span<std::byte> buffer, TimerClock::time_point deadline) const -> Task<ssize_t>;
+    
+    //! Read data into a buffer leased from the BufferPool - suspends if no data available.
+    //! The buffer is only leased once data is ready, so idle connections don't hold one.
+    //! In multishot mode this pops the next completed receive and `max_bytes` is ignored.
+    //! Returns an empty Buffer on EOF (`error()` is 0) or error (`error()` is set).
+    [[nodiscard]] auto read(size_t max_bytes = kDefaultReadSize) const -> Task<Buffer>;
+    
+    //! Switch reads to multishot mode: the event loop stays armed for this socket and reads each
+    //! arrival into a pooled buffer of `buffer_size` bytes as soon as it is readable, queueing up to
+    //! kRecvRingSize completions. `read` then consumes completions without arming a wait or issuing
+    //! a syscall. Call before any read is pending on the socket.
+    void enable_multishot_recv(size_t buffer_size = kDefaultReadSize);
+    
+    //! Write data to socket - suspends if write would block.
+    //! Returns the bytes written or a negative errno.
     [[nodiscard]] auto write(std::span<const std::byte> data) const -> Task<ssize_t>;
     
+    //! Write data to socket, giving up at `deadline` - returns -ETIMEDOUT if the socket didn't
+    //! become writable in time.
+    [[nodiscard]] auto write(std::span<const std::byte> data, TimerClock::time_point deadline) const -> Task<ssize_t>;
+    
+    //! Write data to socket with MSG_ZEROCOPY - suspends until the kernel no longer references `data`.
+    //! The buffer must stay alive and unmodified until the returned task completes.
+    //! Falls back to `write` for small buffers or when the kernel reports it had to copy anyway.
+    [[nodiscard]] auto send_zerocopy(std::span<const std::byte> data) -> Task<ssize_t>;
+    
+    //! MSG_ZEROCOPY sends whose completion hasn't been reaped yet (0 once `send_zerocopy` returns).
+    [[nodiscard]] auto zerocopy_pending() const noexcept -> uint32_t {
+        return zerocopy_pending_;
+    }
+    
+    //! Pass a file descriptor to the peer of a unix domain socket (SCM_RIGHTS).
+    //! The caller keeps ownership of `fd`; the peer receives its own duplicate.
+    [[nodiscard]] auto send_fd(int fd) const -> Task<ssize_t>;
+    
+    //! Receive a file descriptor sent with `send_fd` - suspends until one arrives.
+    //! Returns a negative errno on failure: -ECONNRESET if the peer closed, -EBADMSG if it sent
+    //! no descriptor.
+    [[nodiscard]] auto recv_fd() const -> Task<int>;
+    
     //! Accept incoming connection - suspends if no connections are pending
     [[nodiscard]] auto accept() const -> Task<Socket>;
     
+    //! Accept incoming connection, giving up at `deadline` - returns an invalid Socket whose
+    //! `error()` is ETIMEDOUT if none arrived in time.
+    [[nodiscard]] auto accept(TimerClock::time_point deadline) const -> Task<Socket>;
+    
     //! Check if socket is valid
     [[nodiscard]] auto is_valid() const noexcept -> bool {
         return fd_ >= 0;
@@ -76,18 +159,78 @@ class Socket {
         return fd_;
     }
     
-  private:
-    void close() noexcept {
-        if (fd_ >= 0) {
-            ::close(fd_);
-            fd_ = -1;
-        }
+    //! Error that left this socket invalid (see `failed`), 0 otherwise.
+    [[nodiscard]] auto error() const noexcept -> int {
+        return error_;
     }
     
+  private:
+    friend class IdleReaper;
+    
+    struct RecvRing;
+    struct WaitForRecv;
+    
+    //! Implementations of the operations above, with an optional deadline.
+    [[nodiscard]] auto read_until(std::span<std::byte> buffer, std::optional<TimerClock::time_point> deadline) const -> Task<ssize_t>;
+    [[nodiscard]] auto write_until(std::span<const std::byte> data, std::optional<TimerClock::time_point> deadline) const -> Task<ssize_t>;
+    [[nodiscard]] auto accept_until(std::optional<TimerClock::time_point> deadline) const -> Task<Socket>;
+    
+    void close() noexcept;
+    
+    //! Start stamping reads and writes into `entry` for an IdleReaper.
+    void set_idle_entry(std::shared_ptr<IdleEntry> entry) noexcept;
+    
+    //! Record traffic for the IdleReaper, if the socket is watched.
+    void mark_active() const noexcept;
+    
+    //! Read everything currently available into `ring` (runs on the event loop thread).
+    static void fill_recv_ring(int fd, RecvRing& ring);
+    
+    //! Drain MSG_ZEROCOPY completion notifications from the socket error queue.
+    //! Returns the number of error queue messages read.
+    auto reap_zerocopy_completions() noexcept -> size_t;
+    
     int fd_ = -1;
+    
+    // SO_ZEROCOPY has been set on the socket.
+    bool zerocopy_enabled_ = false;
+    
+    // The kernel reported a zerocopy send was copied (e.g. loopback), so zerocopy buys nothing.
+    bool zerocopy_copied_ = false;
+    
+    // Number of MSG_ZEROCOPY sends whose completion has not been reaped yet.
+    uint32_t zerocopy_pending_ = 0;
+    
+    // Why the operation that returned this invalid socket failed.
+    int error_ = 0;
+    
+    // Completed receives in multishot mode, shared with the event loop callback.
+    std::shared_ptr<RecvRing> recv_ring_;
+    
+    // Idle tracking state when watched by an IdleReaper.
+    std::shared_ptr<IdleEntry> idle_;
 };
 
+//! Build an IPv4 address for host:port (nullptr or "0.0.0.0" means any interface)
+auto parse_address(const char* host, int port) -> std::optional<sockaddr_in>;
+
 //! Create a listening socket bound to host:port
 auto listen(const char* host, int port) -> Socket;
 
+//! Connect to host:port - suspends until the connection is established.
+//! Returns an invalid Socket on failure, with the cause in `error()`.
+[[nodiscard]] auto connect(const char* host, int port) -> Task<Socket>;
+
+//! Create a listening unix domain socket bound to `path`, replacing a socket file a previous
+//! process left behind. Fails with EADDRINUSE (in `error()` and errno) if `path` is any other file
+//! or a live socket.
+auto listen_unix(const char* path) -> Socket;
+
+//! Connect to the unix domain socket at `path` - suspends until the connection is established.
+//! Returns an invalid Socket on failure, with the cause in `error()`.
+[[nodiscard]] auto connect_unix(const char* path) -> Task<Socket>;
+
+//! Create a pair of connected unix domain sockets
+auto socketpair() -> std::pair<Socket, Socket>;
+
 } // namespace vial
\ No newline at end of file
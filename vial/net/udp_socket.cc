@@ -0,0 +1,165 @@
+#include "udp_socket.hh"
+#include <netinet/udp.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace vial::net {
+
+namespace {
+
+//! Ancillary data buffer large enough for a UDP_GRO/UDP_SEGMENT control message.
+struct alignas(cmsghdr) UdpControl {
+    std::array<char, CMSG_SPACE(sizeof(int))> data;
+};
+
+} // namespace
+
+auto UdpSocket::enable_gro() const -> bool {
+    int opt = 1;
+    return setsockopt(fd(), SOL_UDP, UDP_GRO, &opt, sizeof(opt)) == 0;
+}
+
+auto UdpSocket::recv_batch(std::span<RecvDatagram> batch) const -> Task<int> {
+    const int fd = this->fd();
+    size_t received = 0;
+
+    std::array<mmsghdr, kMaxUdpBatch> msgs{};
+    std::array<iovec, kMaxUdpBatch> iovs{};
+    std::array<UdpControl, kMaxUdpBatch> controls{};
+
+    while (received < batch.size()) {
+        auto pending = batch.subspan(received, std::min(batch.size() - received, kMaxUdpBatch));
+
+        for (size_t i = 0; i < pending.size(); i++) {
+            iovs.at(i) = {pending[i].buffer.data(), pending[i].buffer.size()};
+            msgs.at(i) = {};
+            msgs.at(i).msg_hdr.msg_name = &pending[i].peer;
+            msgs.at(i).msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            msgs.at(i).msg_hdr.msg_iov = &iovs.at(i);
+            msgs.at(i).msg_hdr.msg_iovlen = 1;
+            msgs.at(i).msg_hdr.msg_control = controls.at(i).data.data();
+            msgs.at(i).msg_hdr.msg_controllen = controls.at(i).data.size();
+        }
+
+        // Try first: a busy socket usually has datagrams queued already
+        int ret = recvmmsg(fd, msgs.data(), pending.size(), MSG_DONTWAIT, nullptr);
+        if (ret < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                co_return received > 0 ? static_cast<int>(received) : -errno;
+            }
+            if (received > 0) { break; }
+
+            if (co_await WaitForRead{fd} == WaitStatus::kCancelled) { co_return -ECANCELED; }
+            continue;
+        }
+
+        for (int i = 0; i < ret; i++) {
+            auto& slot = pending[i];
+            auto& hdr = msgs.at(i).msg_hdr;
+            slot.size = msgs.at(i).msg_len;
+            slot.segment_size = 0;
+
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int segment_size = 0;
+                    std::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+                    slot.segment_size = static_cast<uint16_t>(segment_size);
+                }
+            }
+        }
+
+        received += ret;
+
+        // A short batch means the socket is drained
+        if (static_cast<size_t>(ret) < pending.size()) { break; }
+    }
+
+    co_return static_cast<int>(received);
+}
+
+auto UdpSocket::send_batch(std::span<const SendDatagram> batch) const -> Task<int> {
+    const int fd = this->fd();
+    size_t sent = 0;
+
+    std::array<mmsghdr, kMaxUdpBatch> msgs{};
+    std::array<iovec, kMaxUdpBatch> iovs{};
+    std::array<UdpControl, kMaxUdpBatch> controls{};
+
+    while (sent < batch.size()) {
+        auto pending = batch.subspan(sent, std::min(batch.size() - sent, kMaxUdpBatch));
+
+        for (size_t i = 0; i < pending.size(); i++) {
+            const auto& datagram = pending[i];
+            iovs.at(i) = {const_cast<std::byte*>(datagram.data.data()), datagram.data.size()}; // NOLINT
+            msgs.at(i) = {};
+            msgs.at(i).msg_hdr.msg_name = const_cast<sockaddr_in*>(&datagram.peer); // NOLINT
+            msgs.at(i).msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            msgs.at(i).msg_hdr.msg_iov = &iovs.at(i);
+            msgs.at(i).msg_hdr.msg_iovlen = 1;
+
+            if (datagram.segment_size > 0) {
+                auto& hdr = msgs.at(i).msg_hdr;
+                hdr.msg_control = controls.at(i).data.data();
+                hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+                cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                std::memcpy(CMSG_DATA(cmsg), &datagram.segment_size, sizeof(uint16_t));
+            }
+        }
+
+        int ret = sendmmsg(fd, msgs.data(), pending.size(), MSG_DONTWAIT);
+        if (ret < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                co_return sent > 0 ? static_cast<int>(sent) : -errno;
+            }
+
+            if (co_await WaitForWrite{fd} == WaitStatus::kCancelled) {
+                co_return sent > 0 ? static_cast<int>(sent) : -ECANCELED;
+            }
+            continue;
+        }
+
+        sent += ret;
+    }
+
+    co_return static_cast<int>(sent);
+}
+
+auto bind_udp(const char* host, int port) -> UdpSocket {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to create UDP socket: " << strerror(errno) << std::endl;
+        return UdpSocket{-1};
+    }
+
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        std::cerr << "Failed to set socket options: " << strerror(errno) << std::endl;
+        ::close(fd);
+        return UdpSocket{-1};
+    }
+
+    auto addr = parse_address(host, port);
+    if (!addr) {
+        std::cerr << "Invalid host address: " << host << std::endl;
+        ::close(fd);
+        return UdpSocket{-1};
+    }
+
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&*addr), sizeof(*addr)) < 0) { // NOLINT
+        std::cerr << "Failed to bind UDP socket to " << host << ":" << port << " - " << strerror(errno) << std::endl;
+        ::close(fd);
+        return UdpSocket{-1};
+    }
+
+    return UdpSocket{fd};
+}
+
+} // namespace vial::net
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <span>
+#include <cstdint>
+#include "socket.hh"
+
+namespace vial::net {
+
+//! Maximum number of messages handed to a single recvmmsg/sendmmsg call.
+constexpr size_t kMaxUdpBatch = 64;
+
+//! Slot filled by `UdpSocket::recv_batch`.
+struct RecvDatagram {
+    //! Buffer to receive into. With GRO enabled, size it for coalesced payloads (up to 64 KiB).
+    std::span<std::byte> buffer;
+
+    //! Number of bytes received into `buffer`.
+    size_t size = 0;
+
+    //! Address of the sender.
+    sockaddr_in peer{};
+
+    //! GRO segment size: `buffer` holds `size / segment_size` (rounded up) datagrams of this size.
+    //! Zero if the payload is a single datagram.
+    uint16_t segment_size = 0;
+};
+
+//! Message sent by `UdpSocket::send_batch`.
+struct SendDatagram {
+    //! Payload to send.
+    std::span<const std::byte> data;
+
+    //! Destination address.
+    sockaddr_in peer{};
+
+    //! GSO segment size: the kernel splits `data` into datagrams of this size. Zero disables GSO.
+    uint16_t segment_size = 0;
+};
+
+//! UDP socket with batched coroutine receive/send
+class UdpSocket {
+  public:
+    //! Default constructor - invalid socket
+    UdpSocket() = default;
+
+    //! Construct UdpSocket from existing file descriptor
+    explicit UdpSocket(int fd) : socket_(fd) {}
+
+    //! Enable UDP GRO so the kernel coalesces same-flow datagrams into a single slot.
+    //! Returns false if the kernel does not support it.
+    auto enable_gro() const -> bool;
+
+    //! Receive up to `batch.size()` datagrams - suspends until at least one is available.
+    //! Keeps draining the socket until the batch is full or it would block.
+    //! Returns the number of filled slots, or a negative errno.
+    [[nodiscard]] auto recv_batch(std::span<RecvDatagram> batch) const -> Task<int>;
+
+    //! Send all datagrams in `batch` - suspends while the send buffer is full.
+    //! Returns the number of messages sent, or a negative errno if none could be sent.
+    [[nodiscard]] auto send_batch(std::span<const SendDatagram> batch) const -> Task<int>;
+
+    //! Check if socket is valid
+    [[nodiscard]] auto is_valid() const noexcept -> bool {
+        return socket_.is_valid();
+    }
+
+    //! Get underlying file descriptor
+    [[nodiscard]] auto fd() const noexcept -> int {
+        return socket_.fd();
+    }
+
+  private:
+    Socket socket_;
+};
+
+//! Create a UDP socket bound to host:port
+auto bind_udp(const char* host, int port) -> UdpSocket;
+
+} // namespace vial::net